@@ -0,0 +1,52 @@
+#pragma once
+
+#pragma region C++ Includes
+#include <cstdint>
+#pragma endregion
+
+/*
+ * Layout of a resource archive (.pak), shared by the
+ * game and the packer tool (so only standard types).
+ * An archive is a header, followed by the entries
+ * (sorted by name, so they can be binary searched),
+ * followed by all the names, followed by the contents
+ * of the files, each starting at an aligned offset.
+ * Names are paths relative to the packed directory,
+ * with '/' separators, each followed by a 0.
+ * Numbers are little endian (all supported targets
+ * are), the archive is used as it is in memory.
+ */
+
+#define ARCHIVE_MAGIC "SPAK"
+#define ARCHIVE_MAGIC_SIZE 4
+#define ARCHIVE_VERSION 1
+//	Contents start at multiples of this, so they can be read in place with any alignment they need
+#define ARCHIVE_ALIGNMENT 16
+//	Name of the archive, next to the executable, and of the directory it replaces
+#define ARCHIVE_FILE_NAME "res.pak"
+#define ARCHIVE_ROOT_NAME "res"
+
+typedef enum
+{
+	AC_None	= 0,	//	Stored as is, read in place
+	AC_Lz4	= 1		//	LZ4 block, decompressed on first use
+} ArchiveCompression;
+
+typedef struct
+{
+	char magic[ARCHIVE_MAGIC_SIZE];
+	uint32_t version;
+	uint32_t entryCount;
+	uint32_t namesSize;	//	Bytes of all names, 0 terminators included
+} ArchiveHeader;
+
+typedef struct
+{
+	uint64_t offset;	//	From the start of the archive
+	uint64_t storedSize;	//	Bytes in the archive
+	uint64_t size;	//	Bytes once decompressed
+	uint32_t nameOffset;	//	From the start of the names
+	uint32_t nameLength;	//	Terminator excluded
+	uint32_t compression;	//	ArchiveCompression
+	uint32_t reserved;
+} ArchiveEntry;
@@ -0,0 +1,323 @@
+#include "AssetManager.h"
+
+#pragma region C++ Includes
+#include <iostream>
+#include <cstring>
+#pragma endregion
+
+#pragma region SDL Includes
+#include "SDL_image.h"
+#include "SDL_mixer.h"
+#pragma endregion
+
+#pragma region Engine Includes
+#include "FontCache.h"
+#include "ResourceArchive.h"
+#include "TextureFormat.h"
+#include "Lz4.h"
+#pragma endregion
+
+Asset::Asset(AssetType type, const string & path, int pointSize) :
+	type(type),
+	path(path),
+	pointSize(pointSize)
+{
+}
+
+Asset * AssetManager::LoadTexture(const string & path)
+{
+	return Request(AT_Texture, path, 0);
+}
+
+Asset * AssetManager::LoadFont(const string & path, int pointSize)
+{
+	return Request(AT_Font, path, pointSize);
+}
+
+Asset * AssetManager::LoadSound(const string & path)
+{
+	return Request(AT_Sound, path, 0);
+}
+
+Asset * AssetManager::LoadMusic(const string & path)
+{
+	return Request(AT_Music, path, 0);
+}
+
+void AssetManager::Release(Asset * asset)
+{
+	if(!asset || asset->references <= 0)
+		return;
+
+	//	Assets still in the hands of a worker are freed when they complete
+	if(--asset->references == 0 && !asset->IsLoading())
+		Destroy(asset);
+}
+
+void AssetManager::Update(SDL_Renderer * r)
+{
+	//	Take what the workers completed since the last frame
+	vector<Asset *> completed;
+	{
+		lock_guard<mutex> lock(loadedMutex);
+		if(loaded.empty() && uploads.empty())
+			return;
+		completed.swap(loaded);
+	}
+
+	//	Decoded textures still need the renderer, everything else is ready to use
+	for(Asset * const & asset : completed)
+		if(asset->pixels)
+			uploads.push_back(asset);
+		else
+			Complete(asset);
+
+	//	Upload in request order, as many textures as the budget allows (but at least one, however big)
+	size_t uploadedBytes = 0;
+	size_t uploadCount = 0;
+	while(uploadCount < uploads.size())
+	{
+		Asset * const asset = uploads[uploadCount];
+		const size_t bytes = (size_t)asset->pixelsPitch * asset->textureSize.y;
+		if(uploadCount > 0 && uploadedBytes + bytes > ASSET_UPLOAD_BUDGET_BYTES)
+			break;
+
+		//	A static texture filled with a single copy, no conversion when the format is native to the renderer
+		asset->texture = SDL_CreateTexture(r, asset->pixelsFormat, SDL_TEXTUREACCESS_STATIC, asset->textureSize.x, asset->textureSize.y);
+		if(asset->texture && SDL_UpdateTexture(asset->texture, nullptr, asset->pixels, asset->pixelsPitch) == 0)
+			SDL_SetTextureBlendMode(asset->texture, SDL_BLENDMODE_BLEND);
+		else
+			asset->error = SDL_GetError();
+		FreePixels(asset);
+
+		Complete(asset);
+		uploadedBytes += bytes;
+		uploadCount++;
+	}
+	uploads.erase(uploads.begin(), uploads.begin() + uploadCount);
+}
+
+int AssetManager::GetPendingCount() const
+{
+	int pending = 0;
+	for(const auto & asset : assets)
+		if(asset.second->IsLoading())
+			pending++;
+
+	return pending;
+}
+
+void AssetManager::Shutdown()
+{
+	//	Let the workers finish what they started, nobody will wait for it anymore
+	if(workers)
+	{
+		delete workers;
+		workers = nullptr;
+	}
+
+	loaded.clear();
+	uploads.clear();
+	while(!assets.empty())
+		Destroy(assets.begin()->second);
+}
+
+Asset * AssetManager::Request(AssetType type, const string & path, int pointSize)
+{
+	//	The same file is loaded only once, further requests share it
+	const AssetKey key(type, path, pointSize);
+	auto cached = assets.find(key);
+	if(cached != assets.end())
+	{
+		cached->second->references++;
+		return cached->second;
+	}
+
+	Asset * asset = new Asset(type, path, pointSize);
+	asset->references = 1;
+	assets[key] = asset;
+
+	if(!workers)
+		workers = new WorkerPool(ASSET_MANAGER_WORKERS);
+	workers->Enqueue([this, asset]() { Decode(asset); });
+
+	return asset;
+}
+
+void AssetManager::Decode(Asset * asset)
+{
+	/*
+	 * Only the asset's results are touched here, the main
+	 * thread won't look at them until the asset is handed
+	 * back through the loaded list (the mutex makes the
+	 * writes visible to it).
+	 */
+	switch(asset->type)
+	{
+		case AT_Texture:
+			if(!DecodeTextureFile(asset))
+				DecodeImage(asset);
+			break;
+		case AT_Font:
+			asset->font = FontCache::Get().Acquire(asset->path, asset->pointSize);
+			if(!asset->font)
+				asset->error = TTF_GetError();
+			break;
+		case AT_Sound:
+		{
+			SDL_RWops * file = ResourceArchive::Get().Open(asset->path);
+			asset->sound = file ? Mix_LoadWAV_RW(file, 1) : nullptr;
+			if(!asset->sound)
+				asset->error = Mix_GetError();
+			break;
+		}
+		case AT_Music:
+		{
+			//	Music is streamed while playing, the stream is closed with it
+			SDL_RWops * file = ResourceArchive::Get().Open(asset->path);
+			asset->music = file ? Mix_LoadMUS_RW(file, 1) : nullptr;
+			if(!asset->music)
+				asset->error = Mix_GetError();
+			break;
+		}
+	}
+
+	lock_guard<mutex> lock(loadedMutex);
+	loaded.push_back(asset);
+}
+
+bool AssetManager::DecodeTextureFile(Asset * asset)
+{
+	//	Same path, different extension
+	const size_t extension = asset->path.find_last_of('.');
+	if(extension == string::npos)
+		return false;
+	const string texturePath = asset->path.substr(0, extension + 1) + TEXTURE_FILE_EXTENSION;
+
+	//	From the archive the file is read in place, otherwise it's loaded in a buffer
+	const void * fileData = nullptr;
+	size_t fileSize = 0;
+	vector<Uint8> & buffer = asset->pixelBuffer;
+	if(!ResourceArchive::Get().Find(texturePath, fileData, fileSize))
+	{
+		SDL_RWops * file = SDL_RWFromFile(texturePath.c_str(), "rb");
+		if(!file)
+			return false;
+		const Sint64 size = SDL_RWsize(file);
+		buffer.resize(size > 0 ? (size_t)size : 0);
+		if(buffer.empty() || SDL_RWread(file, buffer.data(), buffer.size(), 1) != 1)
+			buffer.clear();
+		SDL_RWclose(file);
+		fileData = buffer.data();
+		fileSize = buffer.size();
+	}
+
+	//	Anything unexpected fails the asset, rather than falling back on the decoder without telling
+	TextureFileHeader header;
+	if(fileSize < sizeof(header))
+	{
+		asset->error = "truncated pre-decoded texture " + texturePath;
+		buffer.clear();
+		return true;
+	}
+	memcpy(&header, fileData, sizeof(header));
+	const Uint8 * data = (const Uint8 *)fileData + sizeof(header);
+	const size_t pixelsSize = (size_t)header.pitch * header.height;
+	if(
+		memcmp(header.magic, TEXTURE_FILE_MAGIC, TEXTURE_FILE_MAGIC_SIZE) != 0 ||
+		header.version != TEXTURE_FILE_VERSION ||
+		header.width == 0 || header.height == 0 ||
+		SDL_BYTESPERPIXEL(header.pixelFormat) != 4 || header.pitch < header.width * 4 ||
+		header.dataSize > fileSize - sizeof(header) ||
+		(header.compression == TC_None && header.dataSize != pixelsSize) ||
+		(header.compression != TC_None && header.compression != TC_Lz4)
+	)
+	{
+		asset->error = "invalid pre-decoded texture " + texturePath;
+		buffer.clear();
+		return true;
+	}
+
+	if(header.compression == TC_Lz4)
+	{
+		vector<Uint8> decompressed(pixelsSize);
+		if(!Lz4::Decompress(data, header.dataSize, decompressed.data(), decompressed.size()))
+		{
+			asset->error = "corrupted pre-decoded texture " + texturePath;
+			buffer.clear();
+			return true;
+		}
+		buffer.swap(decompressed);
+		data = buffer.data();
+	}
+
+	asset->pixels = data;
+	asset->pixelsPitch = (int)header.pitch;
+	asset->pixelsFormat = header.pixelFormat;
+	asset->textureSize = Vector2((int)header.width, (int)header.height);
+	return true;
+}
+
+void AssetManager::DecodeImage(Asset * asset)
+{
+	//	Decode and convert to the usual texture format, so the upload is a plain copy
+	SDL_RWops * file = ResourceArchive::Get().Open(asset->path);
+	SDL_Surface * image = file ? IMG_Load_RW(file, 1) : nullptr;
+	if(image)
+	{
+		asset->surface = SDL_ConvertSurfaceFormat(image, SDL_PIXELFORMAT_ARGB8888, 0);
+		SDL_FreeSurface(image);
+	}
+	if(!asset->surface)
+	{
+		asset->error = SDL_GetError();
+		return;
+	}
+
+	asset->pixels = asset->surface->pixels;
+	asset->pixelsPitch = asset->surface->pitch;
+	asset->pixelsFormat = asset->surface->format->format;
+	asset->textureSize = Vector2(asset->surface->w, asset->surface->h);
+}
+
+void AssetManager::FreePixels(Asset * asset)
+{
+	if(asset->surface)
+	{
+		SDL_FreeSurface(asset->surface);
+		asset->surface = nullptr;
+	}
+	vector<Uint8>().swap(asset->pixelBuffer);
+	asset->pixels = nullptr;
+}
+
+void AssetManager::Complete(Asset * asset)
+{
+	if(asset->error.empty())
+		asset->state = AS_Ready;
+	else
+	{
+		asset->state = AS_Failed;
+		cout << "Couldn't load asset " << asset->path << " [ERROR]: " << asset->error << endl;
+	}
+
+	//	Released while loading
+	if(asset->references == 0)
+		Destroy(asset);
+}
+
+void AssetManager::Destroy(Asset * asset)
+{
+	FreePixels(asset);
+	if(asset->texture)
+		SDL_DestroyTexture(asset->texture);
+	if(asset->font)
+		FontCache::Get().Release(asset->path, asset->pointSize);
+	if(asset->sound)
+		Mix_FreeChunk(asset->sound);
+	if(asset->music)
+		Mix_FreeMusic(asset->music);
+
+	assets.erase(AssetKey(asset->type, asset->path, asset->pointSize));
+	delete asset;
+}
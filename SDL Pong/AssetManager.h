@@ -0,0 +1,182 @@
+#pragma once
+
+#pragma region C++ Includes
+#include <string>
+#include <vector>
+#include <map>
+#include <tuple>
+#include <mutex>
+#include <atomic>
+#pragma endregion
+
+#pragma region SDL Includes
+#include "SDL.h"
+#pragma endregion
+
+#pragma region Engine Includes
+#include "Types.h"
+#include "WorkerPool.h"
+#pragma endregion
+
+using namespace std;
+
+//	Threads decoding files in the background
+#define ASSET_MANAGER_WORKERS 2
+//	Pixels uploaded to the GPU per frame, at least one texture is uploaded each frame anyway
+#define ASSET_UPLOAD_BUDGET_BYTES (4 * 1024 * 1024)
+
+typedef enum
+{
+	AT_Texture	= 0,
+	AT_Font		= 1,
+	AT_Sound	= 2,
+	AT_Music	= 3
+} AssetType;
+
+typedef enum
+{
+	AS_Loading	= 0,
+	AS_Ready	= 1,
+	AS_Failed	= 2
+} AssetState;
+
+/*
+ * A resource requested to the asset manager and the
+ * handle to it: it starts loading and, at some frame,
+ * becomes either ready or failed. Getters return
+ * nullptr until the asset is ready.
+ * State only changes on the thread rendering (during
+ * AssetManager::Update()) and it's atomic, so it can
+ * be checked at any time during update and render,
+ * even when they run on different threads: once an
+ * asset reads as ready, its results can be used.
+ */
+class Asset
+{
+	friend class AssetManager;
+	// Fields
+public:
+protected:
+private:
+	const AssetType type;
+	const string path;
+	const int pointSize;	//	Fonts only
+	atomic<AssetState> state{AS_Loading};	//	Written after the results, read before them
+	int references = 0;
+	//	Results, written by the worker while loading, by the thread rendering afterwards
+	SDL_Surface * surface = nullptr;	//	Decoded image, owns the pixels below
+	vector<Uint8> pixelBuffer;	//	Decompressed pre-decoded texture, owns the pixels below
+	const void * pixels = nullptr;	//	Pixels waiting to be uploaded (in the surface, in the buffer or in the archive)
+	int pixelsPitch = 0;
+	Uint32 pixelsFormat = SDL_PIXELFORMAT_UNKNOWN;
+	SDL_Texture * texture = nullptr;
+	Vector2 textureSize{0, 0};
+	struct _TTF_Font * font = nullptr;
+	struct Mix_Chunk * sound = nullptr;
+	struct _Mix_Music * music = nullptr;
+	string error;
+	// Constructors
+public:
+	// Delete copy constructor and assignment operator (assets are shared through pointers)
+	Asset(const Asset &) = delete;
+	Asset & operator=(const Asset &) = delete;
+protected:
+private:
+	Asset(AssetType type, const string & path, int pointSize);
+	// Methods
+public:
+	__inline AssetType GetType() const { return type; }
+	__inline const string & GetPath() const { return path; }
+	__inline AssetState GetState() const { return state; }
+	__inline bool IsLoading() const { return state == AS_Loading; }
+	__inline bool IsReady() const { return state == AS_Ready; }
+	__inline bool IsFailed() const { return state == AS_Failed; }
+
+	__inline SDL_Texture * GetTexture() const { return IsReady() ? texture : nullptr; }
+	__inline Vector2 GetTextureSize() const { return IsReady() ? textureSize : Vector2(0, 0); }
+	__inline struct _TTF_Font * GetFont() const { return IsReady() ? font : nullptr; }
+	__inline struct Mix_Chunk * GetSound() const { return IsReady() ? sound : nullptr; }
+	__inline struct _Mix_Music * GetMusic() const { return IsReady() ? music : nullptr; }
+protected:
+private:
+};
+
+/*
+ * Loads textures, fonts and audio in the background,
+ * so that no frame stalls waiting for the disk or
+ * for a decoder.
+ * Files are read and decoded by worker threads, the
+ * thread rendering only turns decoded images into
+ * textures (renderers can't be used from other
+ * threads), a few per frame within a budget of bytes,
+ * so even a burst of requests is spread over several
+ * frames.
+ * Images converted offline to pre-decoded textures
+ * (see TextureFormat.h and tools/texconv) are picked
+ * instead of the original file when found next to
+ * it, with the same name: they skip the decoder and
+ * go straight to the upload.
+ * Requests for the same file share the same asset,
+ * which is reference counted: every Load*() must be
+ * matched by a Release(), the last one frees it.
+ *
+ * When targetting webgl there are no threads and
+ * files are decoded as soon as they're requested
+ * (see WorkerPool), uploads are still spread across
+ * frames.
+ */
+class AssetManager
+{
+	// Fields
+public:
+protected:
+private:
+	typedef tuple<AssetType, string, int> AssetKey;
+
+	map<AssetKey, Asset *> assets;
+	WorkerPool * workers = nullptr;	//	Created with the first request
+	vector<Asset *> loaded;	//	Assets the workers are done with, waiting for Update()
+	mutex loadedMutex;
+	vector<Asset *> uploads;	//	Decoded textures waiting for their turn to be uploaded
+	// Constructors
+public:
+	// Delete copy constructor and assignment operator (singleton protection)
+	AssetManager(const AssetManager &) = delete;
+	AssetManager & operator=(const AssetManager &) = delete;
+protected:
+private:
+	AssetManager() { }
+	// Methods
+public:
+	static AssetManager & Get()
+	{
+		//	Singleton implementation
+		static AssetManager instance;
+		return instance;
+	}
+	//	Requests, all return immediately with an asset that is loading (or already loaded, if requested before)
+	Asset * LoadTexture(const string & path);
+	Asset * LoadFont(const string & path, int pointSize);
+	Asset * LoadSound(const string & path);
+	Asset * LoadMusic(const string & path);
+	//	Drops a reference to an asset (nullptr is ignored)
+	void Release(Asset * asset);
+	//	Completes loaded assets and uploads textures, call once per frame before rendering
+	void Update(SDL_Renderer * r);
+	//	Number of assets still loading
+	int GetPendingCount() const;
+	//	Waits for the workers and frees all assets, call before closing audio, fonts and the renderer
+	void Shutdown();
+protected:
+private:
+	Asset * Request(AssetType type, const string & path, int pointSize);
+	//	Run on a worker thread
+	void Decode(Asset * asset);
+	//	Returns false if the image has no pre-decoded texture
+	bool DecodeTextureFile(Asset * asset);
+	void DecodeImage(Asset * asset);
+	void FreePixels(Asset * asset);
+	//	Marks an asset ready or failed, on the thread rendering
+	void Complete(Asset * asset);
+	void Destroy(Asset * asset);
+};
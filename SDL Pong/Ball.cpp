@@ -1,7 +1,6 @@
 #include "Ball.h"
 
 #pragma region C++ Includes
-#include <random>
 #include <iostream>
 #include <sstream>
 #include <cmath>
@@ -14,9 +13,16 @@
 
 #pragma region Engine Includes
 #include "PathUtils.h"
+#include "AssetManager.h"
+#pragma endregion
+
+#pragma region Game Includes
+#include "PongRules.h"
 #pragma endregion
 
 #define Sign(number) (number >= 0 ? 1 : -1)
+//	Maximum number of bounces the ball can make within a single move, the rest of the movement is dropped
+#define MAX_BOUNCES_PER_MOVE 4
 
 using namespace std;
 
@@ -28,148 +34,204 @@ Ball::~Ball()
 	FreeChunk(goalSFX);
 }
 
-void Ball::SetDirection(BallDirection newDirection)
-{
-	direction = newDirection;
-}
-
-void Ball::RandomizeDirection()
+void Ball::RandomizeDirection(Random & random)
 {
 	/*
-	 * Random in C and C++ isn't trivial as we're used to
-	 * with C#.
-	 * C had its own way to generate random numbers, based
-	 * on a pseudo-random function and a seed, a number on
-	 * which calculate a sequence of random numbers. This
-	 * seed could be taken from different sources, the most
-	 * common was the current timestamp.
-	 * C++ introduced a more precise random number generation
-	 * method, based on a random engine and a distribution.
-	 * The random engine follows the same seed logic as C
-	 * and a good way to get a random number is to take the
-	 * id of a random device.
+	 * The random stream belongs to the game, not to the
+	 * ball: all the randomness of a match comes from a
+	 * single seeded sequence, so the match can be played
+	 * again exactly from its seed.
 	 */
-	random_device rd;
-	default_random_engine engine(rd());
-	uniform_int_distribution<int> random(1, 4);
-
-	SetDirection((BallDirection)random(engine));
+	//	NE, NW, SE, SW
+	static const int directionX[] = {1, -1, 1, -1};
+	static const int directionY[] = {-1, -1, 1, 1};
+	const int direction = (int)random.Below(4);
+	SetVelocity(FixedVector2(directionX[direction] * GetSpeed(), directionY[direction] * GetSpeed()));
 }
 
 void Ball::Place(int x, int y)
 {
-	t.position.x = x;
-	t.position.y = y;
-	SetDirection(BD_Still);
+	Teleport(FixedVector2(FixedFromInt(x), FixedFromInt(y)));
+	SetVelocity(FixedVector2(0, 0));
 }
 
-void Ball::KickOff()
+void Ball::KickOff(Random & random)
 {
-	if(direction == BD_Still)
-		RandomizeDirection();
+	if(IsStill())
+		RandomizeDirection(random);
 }
 
-void Ball::FlipDirectionV()
+BodyId Ball::ConsumePoint()
 {
-	switch(direction)
-	{
-		case BD_NE:
-			SetDirection(BD_SE);
-			break;
-		case BD_NW:
-			SetDirection(BD_SW);
-			break;
-		case BD_SE:
-			SetDirection(BD_NE);
-			break;
-		case BD_SW:
-			SetDirection(BD_NW);
-			break;
-		default:
-			//	Do nothing
-			break;
-	}
+	const BodyId pointCache = point;
+	point = NO_BODY;
+	return pointCache;
 }
 
-void Ball::FlipDirectionH()
+void Ball::Update()
 {
-	switch(direction)
-	{
-		case BD_NE:
-			SetDirection(BD_NW);
-			break;
-		case BD_NW:
-			SetDirection(BD_NE);
-			break;
-		case BD_SE:
-			SetDirection(BD_SW);
-			break;
-		case BD_SW:
-			SetDirection(BD_SE);
-			break;
-		default:
-			//	Do nothing
-			break;
-	}
+	if(HasPoint())
+		return;
+
+	//	Other bodies (e.g. paddles) may have moved onto the ball since the last update
+	ResolveOverlaps();
+	if(HasPoint())
+		return;
+
+	SweptMove(GetVelocity());
 }
 
-const Body * Ball::ConsumePoint()
+void Ball::PostMoveOperations()
 {
-	const Body * pointCache = point;
-	point = nullptr;
-	return pointCache;
+	//	The ball has been moved without sweeping, fix any overlap it ended in
+	ResolveOverlaps();
 }
 
-void Ball::Update()
+void Ball::SweptMove(FixedVector2 offset)
 {
-	if(point)
-		return;
+	/*
+	 * Instead of moving the ball and then checking what
+	 * it overlaps (which misses thin bodies when the ball
+	 * moves more than their size in one step), the whole
+	 * movement is swept against the registered bodies to
+	 * find the first one the ball touches along the way.
+	 * The ball is moved exactly up to that contact, then
+	 * it bounces: its direction and what's left of the
+	 * movement are reflected on the axis of the touched
+	 * side, and the sweep goes on from there. This way
+	 * the ball travels the right distance in every step,
+	 * no matter how long the step is, and can bounce
+	 * more than once (e.g. border then paddle).
+	 * All of it is done on exact (fixed point) rects, so
+	 * contacts are found and reached to the fraction of
+	 * a pixel.
+	 */
+	Fixed dx = offset.x;
+	Fixed dy = offset.y;
+	Fixed left = FIXED_ONE;	//	Fraction of the move still to do
 
-	Vector2 moveDir{0, 0};
+	for(int bounce = 0; bounce < MAX_BOUNCES_PER_MOVE && (dx != 0 || dy != 0); bounce++)
+	{
+		const FixedRect currentRect = GetFixedRect();
 
-	if(
-		direction == BD_NE ||
-		direction == BD_SE
-		)
-		moveDir.x++;
-	else if(
-		direction == BD_NW ||
-		direction == BD_SW
-		)
-		moveDir.x--;
+		//	Nothing along the way, complete the movement
+		BodyId contact;
+		SweepHit hit;
+		if(!FindFirstContact(currentRect, dx, dy, contact, hit))
+		{
+			world.Translate(id, dx, dy);
+			return;
+		}
 
-	if(
-		direction == BD_NE ||
-		direction == BD_NW
-		)
-		moveDir.y--;
-	else if(
-		direction == BD_SE ||
-		direction == BD_SW
-		)
-		moveDir.y++;
+		//	Move up to the contact, exactly on the axis of the touched side
+		const FixedRect contactRect = world.GetFixedRect(contact);
+		Fixed moveX, moveY;
+		if(hit.normalX != 0)
+		{
+			moveX = hit.normalX < 0 ? contactRect.x - (currentRect.x + currentRect.w) : (contactRect.x + contactRect.w) - currentRect.x;
+			moveY = FixedMul(dy, hit.time);
+		}
+		else
+		{
+			moveX = FixedMul(dx, hit.time);
+			moveY = hit.normalY < 0 ? contactRect.y - (currentRect.y + currentRect.h) : (contactRect.y + contactRect.h) - currentRect.y;
+		}
+		world.Translate(id, moveX, moveY);
+		dx -= moveX;
+		dy -= moveY;
+		left -= FixedMul(left, hit.time);
+
+		//	Reaching a goal scores a point and stops the ball
+		if(Collision::GetBit(goalsMask.data(), contact))
+		{
+			SetVelocity(FixedVector2(0, 0));
+			point = contact;
+			PlaySFX(goalSFX, 2);
+			return;
+		}
+
+		//	Paddles return the ball from their front side only, the rest of the move follows the new velocity
+		const bool paddle = Collision::GetBit(paddlesMask.data(), contact);
+		if(paddle && hit.normalX != 0 && (hit.normalX > 0) == Collision::GetBit(rightFrontsMask.data(), contact))
+		{
+			ReturnFromPaddle(GetFixedRect(), contactRect);
+			dx = FixedMul(GetVelocity().x, left);
+			dy = FixedMul(GetVelocity().y, left);
+		}
+		//	Anything else bounces straight off the touched side
+		else if(hit.normalX != 0)
+		{
+			FlipDirectionH();
+			dx = -dx;
+		}
+		else
+		{
+			FlipDirectionV();
+			dy = -dy;
+		}
+
+		//	Play the sound of what has been hit
+		if(paddle)
+			PlaySFX(paddleSFX, 1);
+		else
+			PlaySFX(obstacleSFX, 0);
+	}
+}
 
-	moveDir *= speed;
+bool Ball::FindFirstContact(const FixedRect & rect, Fixed dx, Fixed dy, BodyId & contact, SweepHit & hit)
+{
+	//	Only bodies within the area covered by the movement can be touched
+	if(world.QueryOverlaps(Collision::SweptBounds(rect, dx, dy), hitsMask) == 0)
+		return false;
+
+	//	Sweep against each candidate and keep the earliest contact (lowest id on ties)
+	bool found = false;
+	const int hitsWords = (int)hitsMask.size();
+	const int collidersWords = (int)collidersMask.size();
+	for(
+		int body = Collision::FirstCommonBit(hitsMask.data(), hitsWords, collidersMask.data(), collidersWords);
+		body >= 0;
+		body = Collision::NextCommonBit(hitsMask.data(), hitsWords, collidersMask.data(), collidersWords, body + 1)
+		)
+	{
+		SweepHit candidate;
+		if(Collision::Sweep(rect, dx, dy, world.GetFixedRect(body), candidate) && (!found || candidate.time < hit.time))
+		{
+			found = true;
+			contact = body;
+			hit = candidate;
+		}
+	}
 
-	Move(moveDir);
+	return found;
 }
 
-void Ball::PostMoveOperations()
+void Ball::ResolveOverlaps()
 {
 	//	Store current presence in scene
-	SDL_Rect currentRect = GetRect();
+	const FixedRect currentRect = GetFixedRect();
+
+	/*
+	 * Instead of testing the ball against each registered
+	 * body, one at a time, the ball is tested against all
+	 * the bodies of the world in a single pass, which
+	 * packs the results in a bit mask (one bit per body).
+	 * Each category of bodies has its own mask, so finding
+	 * what was hit is just a matter of and-ing masks.
+	 * If the ball overlaps more bodies of the same category,
+	 * the one with the lowest id (the first registered) wins.
+	 */
+	if(world.QueryOverlaps(currentRect, hitsMask) == 0)
+		return;
 
 	//	Check intersections with goals to determine points
-	for(const Body * const & goal : goals)
+	const BodyId goal = FirstHit(goalsMask);
+	if(goal != NO_BODY)
 	{
-		SDL_Rect goalRect = goal->GetRect();
-		if(SDL_HasIntersection(&currentRect, &goalRect))
-		{
-			SetDirection(BD_Still);
-			point = goal;
-			PlaySFX(goalSFX, 2);
-			return;
-		}
+		SetVelocity(FixedVector2(0, 0));
+		point = goal;
+		PlaySFX(goalSFX, 2);
+		return;
 	}
 
 	/*
@@ -189,7 +251,7 @@ void Ball::PostMoveOperations()
 	 * - two objects will always collide the same way
 	 *		- obstacles vertically
 	 *		- paddles horizontally
-	 * - the speed of the ball is fixed and low
+	 * - the speed of the ball is low
 	 * Based on those (many) assumptions, resolving overlaps
 	 * becomes really easy. We consider only the axis we know
 	 * is causing an overlap (x for paddles, y for obstacles),
@@ -198,60 +260,52 @@ void Ball::PostMoveOperations()
 	 * exact distance, depending on the side of the ball
 	 * relative to the other body.
 	 * 
-	 * A big problem here, that will come out for sure if
-	 * we increase the ball's speed, is that this is not a
-	 * physical simulation and ignores the velocity and where
-	 * the ball comes from, making a discrete collision detection
-	 * that can lead to ofershooting the other body.
-	 * Implementing a continuous collision detection wouldn't
-	 * be that hard but it would require a little refactoring
-	 * to pass informatin about the position of the ball
-	 * before it moved, that, in conjunction with the current
-	 * position of the ball itself, gives an information of
-	 * movement and so it would be possible to intersect the
-	 * movement with the other body or simply to check if the
-	 * sign of the relative position changes before and after
-	 * the movement.
+	 * This discrete check ignores where the ball comes from
+	 * and can overshoot thin bodies at high speeds, that's
+	 * why the ball's own movement goes through SweptMove().
+	 * It's still needed for overlaps the sweep can't see,
+	 * i.e. other bodies (paddles) moving onto the ball.
 	 */
 
 	//	Check intersections with obstacles to bounce away
-	for(const Body * const & obstacle : obstacles)
+	const BodyId obstacle = FirstHit(obstaclesMask);
+	if(obstacle != NO_BODY)
 	{
-		SDL_Rect obstacleRect = obstacle->GetRect();
-		if(SDL_HasIntersection(&currentRect, &obstacleRect))
-		{
-			//	Bounce up<->down
-			FlipDirectionV();
+		//	Bounce up<->down
+		FlipDirectionV();
 
-			//	Resolve compenetrations
-			ResolveOverlap(currentRect, obstacleRect, Axis::Y);
+		//	Resolve compenetrations
+		ResolveOverlap(currentRect, world.GetFixedRect(obstacle), Axis::Y);
 
-			//	Play obstacle bounce sound
-			PlaySFX(obstacleSFX, 0);
-			break;
-		}
+		//	Play obstacle bounce sound
+		PlaySFX(obstacleSFX, 0);
 	}
 
-	//	Check intersection with paddles to bounce away
-	for(const Body * const & paddle : paddles)
-	{
-		SDL_Rect obstacleRect = paddle->GetRect();
-		if(SDL_HasIntersection(&currentRect, &obstacleRect))
-		{
-			//	Bounce left<->right
-			FlipDirectionH();
-
-			//	Resolve compenetrations
-			ResolveOverlap(currentRect, obstacleRect, Axis::X);
+	/*
+	 * Check intersection with paddles: a paddle moving onto
+	 * the ball only pushes it out, the velocity is left
+	 * alone. If the ball is heading into the paddle, the
+	 * sweep finds the contact right away and returns it
+	 * (see SweptMove()), so a contact is never returned
+	 * twice, not even while the ball stays pinned.
+	 */
+	const BodyId paddle = FirstHit(paddlesMask);
+	if(paddle != NO_BODY)
+		ResolveOverlap(currentRect, world.GetFixedRect(paddle), Axis::X);
+}
 
-			//	Play paddle bounce sound
-			PlaySFX(paddleSFX, 1);
-			break;
-		}
-	}
+void Ball::ReturnFromPaddle(const FixedRect & currentRect, const FixedRect & paddleRect)
+{
+	SetVelocity(RulesPaddleReturn(
+		GetVelocity(),
+		currentRect.y + currentRect.h / 2,
+		paddleRect.y + paddleRect.h / 2,
+		(currentRect.h + paddleRect.h) / 2,
+		maxSpeed
+	));
 }
 
-void Ball::LoadMixerChunk(const char * & chunkSfxPath, Mix_Chunk * & destination)
+void Ball::LoadMixerChunk(const char * & chunkSfxPath, Asset * & destination)
 {
 	//	Free memory for the possible currently loaded sfx
 	FreeChunk(destination);
@@ -259,7 +313,7 @@ void Ball::LoadMixerChunk(const char * & chunkSfxPath, Mix_Chunk * & destination
 	//	Build the full path
 	string fullPath = PathUtils::Combine(
 		{
-			SDL_GetBasePath(),
+			PathUtils::GetBasePath(),
 			"res",
 			"sound",
 			"sfx",
@@ -267,39 +321,68 @@ void Ball::LoadMixerChunk(const char * & chunkSfxPath, Mix_Chunk * & destination
 		}
 	);
 
-	//	Load chunk from wav file
-	destination = Mix_LoadWAV(fullPath.c_str());
-
-	if(!destination)
-		cout << "Couldn't load sound effect at " << fullPath << " [ERROR]: " << Mix_GetError() << endl;
+	//	Request the chunk, the asset manager reports loading errors
+	destination = AssetManager::Get().LoadSound(fullPath);
 }
 
-void Ball::PlaySFX(Mix_Chunk * & sfx, int channel)
+void Ball::PlaySFX(Asset * & sfx, int channel)
 {
-	//	Check if there is any chunk to play
-	if(!sfx)
+	//	Check if there is any chunk to play (it could still be loading)
+	Mix_Chunk * chunk = sfx ? sfx->GetSound() : nullptr;
+	if(!chunk)
 		return;
 
 	//	Play the chunk on the given channel once
-	Mix_PlayChannel(channel, sfx, 0);
+	Mix_PlayChannel(channel, chunk, 0);
 }
 
-void Ball::FreeChunk(Mix_Chunk * & sfx)
+void Ball::FreeChunk(Asset * & sfx)
 {
 	if(!sfx)
 		return;
 
-	Mix_FreeChunk(sfx);
+	AssetManager::Get().Release(sfx);
 	sfx = nullptr;
 }
 
-void Ball::ResolveOverlap(const SDL_Rect & currentRect, const SDL_Rect & obstacleRect, Axis axis)
+void Ball::AddPaddle(const Body * newPaddle, bool frontRight)
+{
+	AddToMask(paddlesMask, newPaddle->GetId());
+
+	//	Any paddle can be looked up, not only those facing right
+	rightFrontsMask.resize(paddlesMask.size(), 0);
+	if(frontRight)
+		Collision::SetBit(rightFrontsMask.data(), newPaddle->GetId());
+}
+
+void Ball::AddToMask(vector<Uint32> & mask, BodyId body)
+{
+	//	Grow the mask to cover the body id
+	const int words = COLLISION_MASK_WORDS(body + 1);
+	if((int)mask.size() < words)
+		mask.resize(words, 0);
+
+	Collision::SetBit(mask.data(), body);
+
+	//	Keep the union of all categories up to date
+	if((int)collidersMask.size() < words)
+		collidersMask.resize(words, 0);
+	Collision::SetBit(collidersMask.data(), body);
+}
+
+BodyId Ball::FirstHit(const vector<Uint32> & mask) const
+{
+	const int hit = Collision::FirstCommonBit(hitsMask.data(), (int)hitsMask.size(), mask.data(), (int)mask.size());
+	return hit < 0 ? NO_BODY : hit;
+}
+
+void Ball::ResolveOverlap(const FixedRect & currentRect, const FixedRect & obstacleRect, Axis axis)
 {
 	//	Resolve overlap on every requested axis
 	if(axis & Axis::X)
 	{
 		//	Get axis shift
-		const int shift = GetOverlapShift(
+		const Fixed shift = GetOverlapShift(
 			currentRect.x,
 			currentRect.w / 2,
 			obstacleRect.x,
@@ -307,12 +390,12 @@ void Ball::ResolveOverlap(const SDL_Rect & currentRect, const SDL_Rect & obstacl
 		);
 
 		//	Apply shift to X axis
-		t.position += Vector2(shift, 0);
+		world.Translate(id, shift, 0);
 	}
 	if(axis & Axis::Y)
 	{
 		//	Get axis shift
-		const int shift = GetOverlapShift(
+		const Fixed shift = GetOverlapShift(
 			currentRect.y,
 			currentRect.h / 2,
 			obstacleRect.y,
@@ -320,19 +403,19 @@ void Ball::ResolveOverlap(const SDL_Rect & currentRect, const SDL_Rect & obstacl
 		);
 
 		//	Apply shift to Y axis
-		t.position += Vector2(0, shift);
+		world.Translate(id, 0, shift);
 	}
 }
 
-int Ball::GetOverlapShift(int currentPos, int currentExtent, int obstaclePos, int obstacleExtent) const
+Fixed Ball::GetOverlapShift(Fixed currentPos, Fixed currentExtent, Fixed obstaclePos, Fixed obstacleExtent) const
 {
 	//	Calculate centers
-	const int currentCenter = currentPos + currentExtent;
-	const int obstacleCenter = obstaclePos + obstacleExtent;
+	const Fixed currentCenter = currentPos + currentExtent;
+	const Fixed obstacleCenter = obstaclePos + obstacleExtent;
 
 	//	Cauclate current and required offset
-	const int currentOffset = currentCenter - obstacleCenter;
-	const int minOffset = currentExtent + obstacleExtent;
+	const Fixed currentOffset = currentCenter - obstacleCenter;
+	const Fixed minOffset = currentExtent + obstacleExtent;
 
 	/*
 	 * In the calculation of the final shift, we could add
@@ -8,60 +8,64 @@
 
 #pragma region Engine Includes
 #include "IUpdatable.h"
+#include "ITransformable.h"	//	Axis
+#include "Collision.h"
+#include "Random.h"
 #pragma endregion
 
 using namespace std;
 
-typedef enum
-{
-	BD_Still	= 0,
-	BD_NE		= 1,
-	BD_NW		= 2,
-	BD_SE		= 3,
-	BD_SW		= 4
-} BallDirection;
-
 /*
  * Class defining the behaviour of the
  * ball in the PONG 2D game.
+ * The ball moves along its velocity, in any
+ * direction: it's kicked off diagonally, bounces
+ * straight off obstacles and is returned by paddles
+ * faster and deflected by where it hit them (see
+ * RulesPaddleReturn()).
  */
 class Ball : public Body, public IUpdatable
 {
 private:
-	BallDirection direction = BD_Still;
-	vector<const Body *> paddles;
-	vector<const Body *> obstacles;
-	vector<const Body *> goals;
-	const Body * point = nullptr;
-	struct Mix_Chunk * obstacleSFX;
-	struct Mix_Chunk * paddleSFX;
-	struct Mix_Chunk * goalSFX;
+	Fixed maxSpeed = FIXED_MAX;	//	Horizontal speed cap of paddle returns
+	vector<Uint32> paddlesMask;	//	Bit mask over body ids, set for registered paddles
+	vector<Uint32> rightFrontsMask;	//	Same size as the paddles mask, set for paddles returning the ball from their right side
+	vector<Uint32> obstaclesMask;	//	Bit mask over body ids, set for registered obstacles
+	vector<Uint32> goalsMask;	//	Bit mask over body ids, set for registered goals
+	vector<Uint32> collidersMask;	//	Union of the masks above, all the bodies the ball interacts with
+	vector<Uint32> hitsMask;	//	Reused on each move to store which bodies the ball overlaps
+	BodyId point = NO_BODY;
+	class Asset * obstacleSFX = nullptr;	//	Sounds are loaded in the background, they stay silent until ready
+	class Asset * paddleSFX = nullptr;
+	class Asset * goalSFX = nullptr;
 
 public:
 	using Body::Body;	//	This inherits base class' constructors
 	~Ball();
-	//	Gives the ball a direction to follow
-	void SetDirection(BallDirection newDirection);
-	//	Gives the ball a random direction to follow
-	void RandomizeDirection();
+	__inline void SetMaxSpeed(Fixed newMaxSpeed) { maxSpeed = newMaxSpeed; }
+	__inline bool IsStill() const { return GetVelocity().x == 0 && GetVelocity().y == 0; }
+	//	Gives the ball a random diagonal direction to follow, at its base speed
+	void RandomizeDirection(Random & random);
 	//	Stops the ball in a given place
 	void Place(int x, int y);
 	//	Sets a random direction to the ball, only if the ball is still
-	void KickOff();
+	void KickOff(Random & random);
 	//	Flips the velocity of the ball on the vertical axis
-	void FlipDirectionV();
+	__inline void FlipDirectionV() { SetVelocity(FixedVector2(GetVelocity().x, -GetVelocity().y)); }
 	//	Flips the velocity of the ball on the horizontal axis
-	void FlipDirectionH();
-	//	Registers a paddle for collision check
-	__inline void AddPaddle(class Body const * newPaddle) { paddles.push_back(newPaddle); }
+	__inline void FlipDirectionH() { SetVelocity(FixedVector2(-GetVelocity().x, GetVelocity().y)); }
+	//	Registers a paddle for collision check, its front (returning the ball) is the side facing the field: right for the left paddle, left for the right one
+	void AddPaddle(class Body const * newPaddle, bool frontRight);
 	//	Registers an obstacle for collision check
-	__inline void AddObstacle(class Body const * newObstacle) { obstacles.push_back(newObstacle); }
+	__inline void AddObstacle(class Body const * newObstacle) { AddToMask(obstaclesMask, newObstacle->GetId()); }
 	//	Registers a goal for trigger check
-	__inline void AddGoal(class Body const * newGoal) { goals.push_back(newGoal); }
-	__inline bool HasPoint() const { return point != nullptr; }
-	__inline const Body * PeekPoint() const { return point; }
-	//	Check if the ball scored a point on any goal. If nullptr, no point was scored. Point is cleared on read, use HasPoint() PeekPoint() if you wanna read without resetting.
-	const Body * ConsumePoint();
+	__inline void AddGoal(class Body const * newGoal) { AddToMask(goalsMask, newGoal->GetId()); }
+	__inline bool HasPoint() const { return point != NO_BODY; }
+	__inline BodyId PeekPoint() const { return point; }
+	//	Puts back a point read with PeekPoint(), when restoring a saved state
+	__inline void RestorePoint(BodyId savedPoint) { point = savedPoint; }
+	//	Check if the ball scored a point on any goal (returns the id of the goal). If NO_BODY, no point was scored. Point is cleared on read, use HasPoint() PeekPoint() if you wanna read without resetting.
+	BodyId ConsumePoint();
 	__inline void SetObstacleSFX(const char * sfxPath) { LoadMixerChunk(sfxPath, obstacleSFX); }
 	__inline void SetPaddleSFX(const char * sfxPath) { LoadMixerChunk(sfxPath, paddleSFX); }
 	__inline void SetGoalSFX(const char * sfxPath) { LoadMixerChunk(sfxPath, goalSFX); }
@@ -70,10 +74,21 @@ public:
 private:
 	//	Overriding this function to receive a message after each move
 	virtual void PostMoveOperations() override;
-	void LoadMixerChunk(const char * & chunkSfxPath, struct Mix_Chunk * & destination);
-	void PlaySFX(struct Mix_Chunk * & sfx, int channel = -1);
-	void FreeChunk(struct Mix_Chunk * & sfx);
-	void ResolveOverlap(const SDL_Rect & currentRect, const SDL_Rect & obstacleRect, Axis axis);
-	int GetOverlapShift(int currentPos, int currentExtent, int obstaclePos, int obstacleExtent) const;
+	//	Moves the ball along offset, bouncing on everything it meets along the way
+	void SweptMove(FixedVector2 offset);
+	//	Finds the first registered body the ball would touch moving rect by (dx, dy), returns false if none
+	bool FindFirstContact(const FixedRect & rect, Fixed dx, Fixed dy, BodyId & contact, SweepHit & hit);
+	//	Pushes the ball out of any body overlapping it
+	void ResolveOverlaps();
+	//	Sends the ball back from a paddle, currentRect is where the ball hit it
+	void ReturnFromPaddle(const FixedRect & currentRect, const FixedRect & paddleRect);
+	void LoadMixerChunk(const char * & chunkSfxPath, class Asset * & destination);
+	void PlaySFX(class Asset * & sfx, int channel = -1);
+	void FreeChunk(class Asset * & sfx);
+	void AddToMask(vector<Uint32> & mask, BodyId body);
+	//	Returns the first body both in the hits mask and in the given mask, NO_BODY if none
+	BodyId FirstHit(const vector<Uint32> & mask) const;
+	void ResolveOverlap(const FixedRect & currentRect, const FixedRect & obstacleRect, Axis axis);
+	Fixed GetOverlapShift(Fixed currentPos, Fixed currentExtent, Fixed obstaclePos, Fixed obstacleExtent) const;
 };
 
@@ -0,0 +1,381 @@
+#include "BatchSimulator.h"
+
+#pragma region C++ Includes
+#include <cstdlib>
+#include <cmath>
+#pragma endregion
+
+#pragma region Engine Includes
+#include "Collision.h"
+#pragma endregion
+
+#pragma region Game Includes
+#include "PongRules.h"
+#pragma endregion
+
+#define Sign(number) (number >= 0 ? 1 : -1)
+//	Same as in Ball.cpp
+#define MAX_BOUNCES_PER_MOVE 4
+//	Layout of the colliders array
+#define COLLIDER_OBSTACLES 0
+#define COLLIDER_GOALS 2
+#define COLLIDER_PADDLES 4
+#define COLLIDERS_COUNT 6
+
+namespace
+{
+	/*
+	 * Same math as World::GetFixedRect(), with scale 1: the
+	 * exact rect of a body placed at (x, y) with the given
+	 * pivot.
+	 * Using the very same fixed point operations keeps the
+	 * batch simulation bit-identical to the game.
+	 */
+	__inline FixedRect BodyRect(Fixed x, Fixed y, int width, int height, Fixed pivotX, Fixed pivotY)
+	{
+		return FixedRect{
+			x - FixedMul(FixedFromInt(width), pivotX),
+			y - FixedMul(FixedFromInt(height), pivotY),
+			FixedFromInt(width),
+			FixedFromInt(height)
+		};
+	}
+	__inline FixedRect BallRect(Fixed x, Fixed y)
+	{
+		return BodyRect(x, y, BALL_SIZE, BALL_SIZE, FIXED_HALF, FIXED_HALF);
+	}
+
+	//	Same as Ball::GetOverlapShift()
+	__inline Fixed OverlapShift(Fixed currentPos, Fixed currentExtent, Fixed obstaclePos, Fixed obstacleExtent)
+	{
+		const Fixed currentOffset = (currentPos + currentExtent) - (obstaclePos + obstacleExtent);
+		const Fixed minOffset = currentExtent + obstacleExtent;
+
+		return Sign(currentOffset) * abs(minOffset - currentOffset);
+	}
+
+	//	Distance from the paddles' pivot to their top edge
+	const Fixed paddleOffsetUp = FixedMul(FixedFromInt(PADDLES_SIZE), FIXED_HALF);
+
+	//	Kick-off directions, same as Ball::RandomizeDirection()
+	const int directionX[] = {1, -1, 1, -1};
+	const int directionY[] = {-1, -1, 1, 1};
+
+	//	Same as Ball::ReturnFromPaddle()
+	__inline void PaddleReturn(const FixedRect & ballRect, const FixedRect & paddleRect, Fixed maxSpeed, Fixed & vx, Fixed & vy)
+	{
+		const FixedVector2 velocity = RulesPaddleReturn(
+			FixedVector2(vx, vy),
+			ballRect.y + ballRect.h / 2,
+			paddleRect.y + paddleRect.h / 2,
+			(ballRect.h + paddleRect.h) / 2,
+			maxSpeed
+		);
+		vx = velocity.x;
+		vy = velocity.y;
+	}
+}
+
+BatchSimulator::BatchSimulator(int matchCount, int fieldWidth, int fieldHeight, int tickRate, Uint64 seed, WorkerPool * pool) :
+	matchCount(matchCount),
+	fieldWidth(fieldWidth),
+	fieldHeight(fieldHeight),
+	ballSpeed(RULES_SCALE_SPEED(BALL_SPEED, tickRate)),
+	ballMaxSpeed(RULES_SCALE_SPEED(BALL_MAX_SPEED, tickRate)),
+	paddleSpeed(RULES_SCALE_SPEED(PADDLES_SPEED, tickRate)),
+	pool(pool),
+	ballX(matchCount),
+	ballY(matchCount),
+	ballVelX(matchCount),
+	ballVelY(matchCount),
+	paddleP1Y(matchCount),
+	paddleP2Y(matchCount),
+	scoreP1(matchCount),
+	scoreP2(matchCount),
+	inputs(matchCount, MI_None),
+	randoms(matchCount)
+{
+	/*
+	 * Lay out the field exactly like PongGame does, with
+	 * the same sizes, positions and pivots.
+	 */
+	//	Goals: left and right edges, full height
+	goalRects[0] = BodyRect(0, FixedFromInt(fieldHeight / 2), GOALS_SIZE, fieldHeight, 0, FIXED_HALF);
+	goalRects[1] = BodyRect(FixedFromInt(fieldWidth), FixedFromInt(fieldHeight / 2), GOALS_SIZE, fieldHeight, FIXED_ONE, FIXED_HALF);
+	//	Borders: top and bottom edges, full width
+	obstacleRects[0] = BodyRect(FixedFromInt(fieldWidth / 2), 0, fieldWidth, BORDERS_SIZE, FIXED_HALF, 0);
+	obstacleRects[1] = BodyRect(FixedFromInt(fieldWidth / 2), FixedFromInt(fieldHeight), fieldWidth, BORDERS_SIZE, FIXED_HALF, FIXED_ONE);
+	//	Paddles: fixed horizontal position, vertical movement limited as in Paddle::PostMoveOperations()
+	paddleX[0] = FixedFromInt(PADDLES_BORDER_OFFSET);
+	paddleX[1] = FixedFromInt(fieldWidth - PADDLES_BORDER_OFFSET);
+	paddleMinY = FixedFromInt(PADDLES_LIMIT_OFFSET) + paddleOffsetUp;
+	paddleMaxY = FixedFromInt(fieldHeight - PADDLES_LIMIT_OFFSET) - (FixedFromInt(PADDLES_SIZE) - paddleOffsetUp);
+
+	//	Give each match its own random stream, reproducible from the batch seed
+	for(int match = 0; match < matchCount; match++)
+	{
+		randoms[match].Seed(seed, match);
+		ResetMatch(match);
+	}
+}
+
+void BatchSimulator::SetAllInputs(Uint8 input)
+{
+	for(Uint8 & matchInput : inputs)
+		matchInput = input;
+}
+
+void BatchSimulator::ResetMatch(int match)
+{
+	ballX[match] = FixedFromInt(fieldWidth / 2);
+	ballY[match] = FixedFromInt(fieldHeight / 2);
+	ballVelX[match] = 0;
+	ballVelY[match] = 0;
+	paddleP1Y[match] = FixedFromInt(fieldHeight / 2);
+	paddleP2Y[match] = FixedFromInt(fieldHeight / 2);
+	scoreP1[match] = 0;
+	scoreP2[match] = 0;
+}
+
+void BatchSimulator::Step(long long steps)
+{
+	if(steps <= 0)
+		return;
+
+	if(pool)
+		pool->ParallelFor(matchCount, [this, steps](int first, int last) { StepRange(first, last, steps); });
+	else
+		StepRange(0, matchCount, steps);
+}
+
+void BatchSimulator::StepRange(int first, int last, long long steps)
+{
+	/*
+	 * Matches are independent, so each one is brought
+	 * forward by all the requested steps before moving
+	 * to the next one: the whole state of a match lives
+	 * in local variables (registers) for the entire
+	 * loop and is written back to the arrays only once.
+	 * Each step follows the order of PongGame::Update():
+	 * kick-off, paddles, ball, scoring.
+	 */
+	FixedRect colliders[COLLIDERS_COUNT];
+
+	for(int match = first; match < last; match++)
+	{
+		Fixed bx = ballX[match];
+		Fixed by = ballY[match];
+		Fixed vx = ballVelX[match];
+		Fixed vy = ballVelY[match];
+		Fixed p1 = paddleP1Y[match];
+		Fixed p2 = paddleP2Y[match];
+		int s1 = scoreP1[match];
+		int s2 = scoreP2[match];
+		Random random = randoms[match];
+		GetColliders(p1, p2, colliders);
+
+		//	Input is constant for the whole call, so is the resulting paddle movement (up and down cancel out, like in Paddle::Update())
+		const Uint8 input = inputs[match];
+		const bool kickOff = (input & MI_KickOff) != 0;
+		const Fixed p1Move = ((input & MI_P1Down) ? paddleSpeed : 0) - ((input & MI_P1Up) ? paddleSpeed : 0);
+		const Fixed p2Move = ((input & MI_P2Down) ? paddleSpeed : 0) - ((input & MI_P2Up) ? paddleSpeed : 0);
+
+		for(long long step = 0; step < steps; step++)
+		{
+			//	Kick-off, only when the ball is still
+			if(kickOff && vx == 0 && vy == 0)
+			{
+				const int direction = (int)random.Below(4);
+				vx = directionX[direction] * ballSpeed;
+				vy = directionY[direction] * ballSpeed;
+			}
+
+			//	Move paddles within their limits
+			p1 += p1Move;
+			if(p1 < paddleMinY)
+				p1 = paddleMinY;
+			else if(p1 > paddleMaxY)
+				p1 = paddleMaxY;
+			p2 += p2Move;
+			if(p2 < paddleMinY)
+				p2 = paddleMinY;
+			else if(p2 > paddleMaxY)
+				p2 = paddleMaxY;
+
+			//	Move the ball, first out of paddles that moved onto it, then along its velocity
+			colliders[COLLIDER_PADDLES + 0].y = p1 - paddleOffsetUp;
+			colliders[COLLIDER_PADDLES + 1].y = p2 - paddleOffsetUp;
+
+			/*
+			 * Most of the time the ball is far from everything: if
+			 * the area covered by its movement (which includes its
+			 * current rect) touches no collider, there's nothing
+			 * to resolve nor to sweep and it can simply move.
+			 */
+			const FixedRect bounds = Collision::SweptBounds(BallRect(bx, by), vx, vy);
+			bool nearColliders = false;
+			for(int collider = 0; collider < COLLIDERS_COUNT; collider++)
+				nearColliders |= Collision::Overlaps(bounds, colliders[collider]);
+			if(!nearColliders)
+			{
+				bx += vx;
+				by += vy;
+				continue;
+			}
+
+			int goal = ResolveOverlaps(bx, by, vy, colliders);
+			if(goal < 0)
+				goal = SweptMove(bx, by, vx, vy, colliders);
+
+			//	Goals: score and place the ball back to the center
+			if(goal >= 0)
+			{
+				if(goal == 0)
+					s2++;
+				else
+					s1++;
+				bx = FixedFromInt(fieldWidth / 2);
+				by = FixedFromInt(fieldHeight / 2);
+				vx = 0;
+				vy = 0;
+			}
+		}
+
+		ballX[match] = bx;
+		ballY[match] = by;
+		ballVelX[match] = vx;
+		ballVelY[match] = vy;
+		paddleP1Y[match] = p1;
+		paddleP2Y[match] = p2;
+		scoreP1[match] = s1;
+		scoreP2[match] = s2;
+		randoms[match] = random;
+	}
+}
+
+void BatchSimulator::GetColliders(Fixed p1, Fixed p2, FixedRect colliders[6]) const
+{
+	colliders[COLLIDER_OBSTACLES + 0] = obstacleRects[0];
+	colliders[COLLIDER_OBSTACLES + 1] = obstacleRects[1];
+	colliders[COLLIDER_GOALS + 0] = goalRects[0];
+	colliders[COLLIDER_GOALS + 1] = goalRects[1];
+	for(int paddle = 0; paddle < 2; paddle++)
+		colliders[COLLIDER_PADDLES + paddle] = BodyRect(paddleX[paddle], paddle == 0 ? p1 : p2, BALL_SIZE, PADDLES_SIZE, FIXED_HALF, FIXED_HALF);
+}
+
+int BatchSimulator::ResolveOverlaps(Fixed & bx, Fixed & by, Fixed & vy, const FixedRect colliders[6]) const
+{
+	const FixedRect ballRect = BallRect(bx, by);
+
+	//	Goals, in order, so P1's goal wins if both are hit
+	for(int goal = 0; goal < 2; goal++)
+		if(Collision::Overlaps(ballRect, colliders[COLLIDER_GOALS + goal]))
+			return goal;
+
+	//	Obstacles: bounce up<->down and resolve the overlap vertically
+	for(int obstacle = 0; obstacle < 2; obstacle++)
+	{
+		const FixedRect & obstacleRect = colliders[COLLIDER_OBSTACLES + obstacle];
+		if(Collision::Overlaps(ballRect, obstacleRect))
+		{
+			vy = -vy;
+			by += OverlapShift(ballRect.y, ballRect.h / 2, obstacleRect.y, obstacleRect.h / 2);
+			break;
+		}
+	}
+
+	//	Paddles: only push the ball out horizontally, the sweep returns it (tested against the pre-bounce rect, like Ball does)
+	for(int paddle = 0; paddle < 2; paddle++)
+	{
+		const FixedRect & paddleRect = colliders[COLLIDER_PADDLES + paddle];
+		if(Collision::Overlaps(ballRect, paddleRect))
+		{
+			bx += OverlapShift(ballRect.x, ballRect.w / 2, paddleRect.x, paddleRect.w / 2);
+			break;
+		}
+	}
+
+	return -1;
+}
+
+int BatchSimulator::SweptMove(Fixed & bx, Fixed & by, Fixed & vx, Fixed & vy, const FixedRect colliders[6]) const
+{
+	//	Remaining movement of this step
+	Fixed mx = vx;
+	Fixed my = vy;
+	Fixed left = FIXED_ONE;
+
+	for(int bounce = 0; bounce < MAX_BOUNCES_PER_MOVE && (mx != 0 || my != 0); bounce++)
+	{
+		const FixedRect ballRect = BallRect(bx, by);
+
+		//	Earliest contact, ties go to the first collider (lowest body id in PongGame)
+		const FixedRect bounds = Collision::SweptBounds(ballRect, mx, my);
+		int contact = -1;
+		SweepHit hit;
+		for(int collider = 0; collider < COLLIDERS_COUNT; collider++)
+		{
+			//	Cheap broad-phase rejection, most colliders are nowhere near the ball
+			if(!Collision::Overlaps(bounds, colliders[collider]))
+				continue;
+
+			SweepHit candidate;
+			if(Collision::Sweep(ballRect, mx, my, colliders[collider], candidate) && (contact < 0 || candidate.time < hit.time))
+			{
+				contact = collider;
+				hit = candidate;
+			}
+		}
+
+		//	Nothing along the way, complete the movement
+		if(contact < 0)
+		{
+			bx += mx;
+			by += my;
+			return -1;
+		}
+
+		//	Move up to the contact, exactly on the axis of the touched side
+		const FixedRect & contactRect = colliders[contact];
+		Fixed moveX, moveY;
+		if(hit.normalX != 0)
+		{
+			moveX = hit.normalX < 0 ? contactRect.x - (ballRect.x + ballRect.w) : (contactRect.x + contactRect.w) - ballRect.x;
+			moveY = FixedMul(my, hit.time);
+		}
+		else
+		{
+			moveX = FixedMul(mx, hit.time);
+			moveY = hit.normalY < 0 ? contactRect.y - (ballRect.y + ballRect.h) : (contactRect.y + contactRect.h) - ballRect.y;
+		}
+		bx += moveX;
+		by += moveY;
+		mx -= moveX;
+		my -= moveY;
+		left -= FixedMul(left, hit.time);
+
+		//	Reaching a goal ends the movement
+		if(contact >= COLLIDER_GOALS && contact < COLLIDER_PADDLES)
+			return contact - COLLIDER_GOALS;
+
+		//	Paddles return the ball from their front side only (P1's right, P2's left), anything else bounces straight off the touched side
+		if(contact >= COLLIDER_PADDLES && hit.normalX != 0 && (hit.normalX > 0) == (contact == COLLIDER_PADDLES + 0))
+		{
+			PaddleReturn(BallRect(bx, by), contactRect, ballMaxSpeed, vx, vy);
+			mx = FixedMul(vx, left);
+			my = FixedMul(vy, left);
+		}
+		else if(hit.normalX != 0)
+		{
+			vx = -vx;
+			mx = -mx;
+		}
+		else
+		{
+			vy = -vy;
+			my = -my;
+		}
+	}
+
+	return -1;
+}
@@ -0,0 +1,109 @@
+#pragma once
+
+#pragma region C++ Includes
+#include <vector>
+#pragma endregion
+
+#pragma region SDL Includes
+#include "SDL.h"
+#pragma endregion
+
+#pragma region Engine Includes
+#include "WorkerPool.h"
+#include "Fixed.h"
+#include "Random.h"
+#pragma endregion
+
+using namespace std;
+
+//	Input bits for a single match of a batch, can be OR'd
+typedef enum
+{
+	MI_None		= 0,
+	MI_P1Up		= 1 << 0,
+	MI_P1Down	= 1 << 1,
+	MI_P2Up		= 1 << 2,
+	MI_P2Down	= 1 << 3,
+	MI_KickOff	= 1 << 4
+} MatchInput;
+
+/*
+ * Simulates many independent PONG matches at once,
+ * following the same rules as PongGame but with no
+ * objects at all: the state of each match is a
+ * handful of integers (positions are fixed point,
+ * like in the game's World) stored in contiguous arrays
+ * (one array per field, one entry per match) and
+ * all matches are advanced by the same tight loop,
+ * optionally split across the cores by a worker
+ * pool.
+ * Field layout and tick rate are the same for all
+ * the matches in a batch, so they're set up once.
+ */
+class BatchSimulator
+{
+	// Fields
+public:
+protected:
+private:
+	const int matchCount;
+	const int fieldWidth;
+	const int fieldHeight;
+	//	Speeds at the tick rate of the batch, same as the game's
+	const Fixed ballSpeed;
+	const Fixed ballMaxSpeed;
+	const Fixed paddleSpeed;
+	WorkerPool * pool;	//	Optional, when null all matches are stepped on the calling thread
+
+	//	Static layout, shared by all matches
+	FixedRect goalRects[2];	//	P1 goal, P2 goal
+	FixedRect obstacleRects[2];	//	Top border, bottom border
+	Fixed paddleX[2];	//	P1, P2
+	Fixed paddleMinY;
+	Fixed paddleMaxY;
+
+	//	Per-match state
+	vector<Fixed> ballX;
+	vector<Fixed> ballY;
+	vector<Fixed> ballVelX;
+	vector<Fixed> ballVelY;
+	vector<Fixed> paddleP1Y;
+	vector<Fixed> paddleP2Y;
+	vector<int> scoreP1;
+	vector<int> scoreP2;
+	vector<Uint8> inputs;	//	MatchInput bits
+	vector<Random> randoms;	//	Random streams used for kick-offs
+	// Constructors
+public:
+	//	Each match draws from its own stream of the seed, the match with index 0 follows the same sequence as a PongGame with that seed and tick rate
+	BatchSimulator(int matchCount, int fieldWidth, int fieldHeight, int tickRate, Uint64 seed, WorkerPool * pool = nullptr);
+protected:
+private:
+	// Methods
+public:
+	__inline int GetMatchCount() const { return matchCount; }
+	//	Sets the input of a match, it's held until changed
+	__inline void SetInput(int match, Uint8 input) { inputs[match] = input; }
+	void SetAllInputs(Uint8 input);
+	__inline Fixed GetBallX(int match) const { return ballX[match]; }
+	__inline Fixed GetBallY(int match) const { return ballY[match]; }
+	__inline Fixed GetBallVelocityX(int match) const { return ballVelX[match]; }
+	__inline Fixed GetBallVelocityY(int match) const { return ballVelY[match]; }
+	__inline Fixed GetPaddleP1Y(int match) const { return paddleP1Y[match]; }
+	__inline Fixed GetPaddleP2Y(int match) const { return paddleP2Y[match]; }
+	__inline int GetScoreP1(int match) const { return scoreP1[match]; }
+	__inline int GetScoreP2(int match) const { return scoreP2[match]; }
+	//	Brings a match back to its initial state (ball still in the center, paddles centered, no score)
+	void ResetMatch(int match);
+	//	Advances all matches by the given number of steps (each step is a PongGame::Update())
+	void Step(long long steps = 1);
+protected:
+private:
+	void StepRange(int first, int last, long long steps);
+	//	Fills the rects the ball interacts with, in the same order as the bodies of PongGame (obstacles, goals, paddles)
+	void GetColliders(Fixed p1, Fixed p2, FixedRect colliders[6]) const;
+	//	Same as Ball::ResolveOverlaps(), returns the goal hit (0 for P1, 1 for P2) or -1
+	int ResolveOverlaps(Fixed & bx, Fixed & by, Fixed & vy, const FixedRect colliders[6]) const;
+	//	Same as Ball::SweptMove(), returns the goal reached (0 for P1, 1 for P2) or -1
+	int SweptMove(Fixed & bx, Fixed & by, Fixed & vx, Fixed & vy, const FixedRect colliders[6]) const;
+};
@@ -1,62 +1,59 @@
 #include "Body.h"
 
-#pragma region Engine Inlcudes
-#include "Colors.h"
+#pragma region Engine Includes
+#include "RenderBatcher.h"
+#include "DirtyRects.h"
 #pragma endregion
 
 
-Body::Body(int width, int height, int bodySpeed) :
-	t{},
-	size{width, height},
-	speed(bodySpeed)
-{
-	Init();
-}
+Body::Body(World & bodyWorld, int width, int height, Fixed bodySpeed) :
+	world(bodyWorld),
+	id(bodyWorld.Add(width, height, bodySpeed))
+{ }
 
-Body::Body(Vector2 bodySize, int bodySpeed) :
-	t{},
-	size(bodySize),
-	speed(bodySpeed)
-{
-	Init();
-}
+Body::Body(World & bodyWorld, Vector2 bodySize, Fixed bodySpeed) :
+	world(bodyWorld),
+	id(bodyWorld.Add(bodySize.x, bodySize.y, bodySpeed))
+{ }
 
-void Body::Move(Vector2 offset)
+void Body::Move(FixedVector2 offset)
 {
-	//	Change the position of the transform
-	t.position += offset;
+	//	Change the position of the body (this invalidates its cached rect)
+	world.Translate(id, offset.x, offset.y);
 
 	//	Run post-move hook
 	PostMoveOperations();
 }
 
-const SDL_Rect Body::GetRect() const
+void Body::PreRender(SDL_Renderer *)
 {
 	/*
-	 * Calculat ethe final rect in SDL-space based on
-	 * size and pivot.
-	 * SDL space has (0, 0) coordinates in the top-left
-	 * corner of the render target. When drawing a rect,
-	 * (x, y) refer to the rect's top-left corner's distance
-	 * from the top-left corner of the render target,
-	 * which isn't always the most handy situation.
-	 * This function calculates the actual extents of the
-	 * rect, taking into account size and scale, and
-	 * offsets it by the pivot value, proportionally.
+	 * Bodies are drawn from the state captured at the
+	 * end of the last tick (which may come from another
+	 * thread), so that's where changes are found: when
+	 * the body is drawn elsewhere or with another color
+	 * than the last time, the old pixels must be covered
+	 * and the new ones drawn.
 	 */
-	SDL_Rect r;
-
-	//	Calculate actual extents
-	r.w = (int)(size.x * t.scale);
-	r.h = (int)(size.y * t.scale);
-	//	Offset by pivot, proportionally
-	r.x = (int)(t.position.x - r.w * t.pivot.x);
-	r.y = (int)(t.position.y - r.h * t.pivot.y);
+	const SDL_Rect renderRect = world.GetRenderRect(id);
+	const SDL_Color & renderColor = world.GetRenderColor(id);
+	if(
+		SDL_RectEquals(&renderRect, &drawnRect) &&
+		renderColor.r == drawnColor.r &&
+		renderColor.g == drawnColor.g &&
+		renderColor.b == drawnColor.b &&
+		renderColor.a == drawnColor.a
+		)
+		return;
 
-	return r;
+	DirtyRects & dirtyRects = DirtyRects::Get();
+	dirtyRects.Invalidate(drawnRect);
+	dirtyRects.Invalidate(renderRect);
+	drawnRect = renderRect;
+	drawnColor = renderColor;
 }
 
-void Body::Render(SDL_Renderer * r) const
+void Body::Render(SDL_Renderer *) const
 {
 	/*
 	 * Here we take care of the rendering to the
@@ -65,36 +62,16 @@ void Body::Render(SDL_Renderer * r) const
 	 * but it will be the main loop to decide
 	 * when to clear and when to swap the back
 	 * and the front buffers.
-	 * We're setting the color for this object
-	 * but remember that alpha will be ignored
-	 * if the current blend mode isn't reading
-	 * from it, that's why, if alpha is not
-	 * full opaque, we set the blend mode to
+	 * Bodies don't draw right away: their rects
+	 * are queued in the render batcher, which draws
+	 * all rects of the same color with one call.
+	 * The batcher also picks the blend mode: alpha
+	 * is ignored if the current blend mode isn't
+	 * reading from it, that's why, if alpha is not
+	 * full opaque, rects are drawn with
 	 * SDL_BLENDMODE_BLEND which computes the
 	 * final color as:
 	 * (srcRGB * srcA) + (dstRGB * (1-srcA))
 	 */
-	SDL_SetRenderDrawColor(
-		r,
-		GetColor().r,
-		GetColor().g,
-		GetColor().b,
-		GetColor().a
-	);
-	if(GetColor().a < 255)
-		SDL_SetRenderDrawBlendMode(r, SDL_BLENDMODE_BLEND);
-	else
-		SDL_SetRenderDrawBlendMode(r, SDL_BLENDMODE_NONE);
-	SDL_Rect currentRect = GetRect();
-	SDL_RenderFillRect(r, &currentRect);
-}
-
-void Body::Init()
-{
-	//	Set default pivot
-	t.pivot.x = 0.5f;
-	t.pivot.y = 0.5f;
-
-	//	Set default color
-	color = SDLC_WHITE;
+	RenderBatcher::Get().FillRect(world.GetRenderRect(id), world.GetRenderColor(id));
 }
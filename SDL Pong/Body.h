@@ -2,42 +2,64 @@
 
 #include "SDL.h"
 
-#include "ITransformable.h"
+#include "World.h"
 #include "IRenderable.h"
 
 /*
  * Generic class for bodies with a rectangular shape
  * that can be placed and moved in the scene as well
  * as rendered.
+ * A body doesn't hold its own state, it's a handle
+ * to an entry of a World, which stores the state of
+ * all bodies in contiguous arrays.
+ * Positions, velocities and speeds are in fixed point
+ * (see Fixed.h), pixel and float setters are there for
+ * placing bodies while setting up a scene.
  */
-class Body : public ITransformable, public IRenderable
+class Body : public IRenderable
 {
 protected:
-	Transform t;	//	Gives a body a place in 2D space
-	Vector2 size;	//	Gives a body a presence in 2D space
-	SDL_Color color;	//	Gives a body a color
-	int speed;	//	Determines at what speed the body moves in the scene
+	World & world;	//	The world storing the state of this body
+	const BodyId id;	//	The entry of this body in its world
+	SDL_Rect drawnRect{0, 0, 0, 0};	//	Where the body was drawn last
+	SDL_Color drawnColor{0, 0, 0, 0};	//	How the body was drawn last
 
 public:
 	//	Constructors
-	Body(int width, int height, int bodySpeed = 0);
-	Body(Vector2 bodySize, int bodySpeed = 0);
-	
-	//	ITransformable implementation + movement
-	Transform * GetTransform() override { return &t; }
-	const Transform * ReadTransform() const override { return &t; }
-	void Move(Vector2 offset);
-	
+	Body(World & bodyWorld, int width, int height, Fixed bodySpeed = 0);
+	Body(World & bodyWorld, Vector2 bodySize, Fixed bodySpeed = 0);
+	// Delete copy constructor and assignment operator (two bodies can't share the same entry)
+	Body(const Body &) = delete;
+	Body & operator=(const Body &) = delete;
+
+	__inline BodyId GetId() const { return id; }
+
+	//	Transform + movement
+	__inline FixedVector2 GetPosition() const { return world.GetPosition(id); }
+	__inline void SetPosition(FixedVector2 newPosition) { world.SetPosition(id, newPosition.x, newPosition.y); }
+	//	In whole pixels
+	__inline void SetPosition(Vector2 newPosition) { world.SetPosition(id, FixedFromInt(newPosition.x), FixedFromInt(newPosition.y)); }
+	//	Places the body with no interpolation from where it was
+	__inline void Teleport(FixedVector2 newPosition) { world.Teleport(id, newPosition.x, newPosition.y); }
+	__inline FixedVector2 GetPivot() const { return world.GetPivot(id); }
+	__inline void SetPivot(Vector2F newPivot) { world.SetPivot(id, FixedFromFloat(newPivot.x), FixedFromFloat(newPivot.y)); }
+	__inline Fixed GetScale() const { return world.GetScale(id); }
+	__inline void SetScale(float newScale) { world.SetScale(id, FixedFromFloat(newScale)); }
+	__inline Vector2 GetSize() const { return world.GetSize(id); }
+	__inline FixedVector2 GetVelocity() const { return world.GetVelocity(id); }
+	__inline void SetVelocity(FixedVector2 newVelocity) { world.SetVelocity(id, newVelocity.x, newVelocity.y); }
+	__inline Fixed GetSpeed() const { return world.GetSpeed(id); }
+	void Move(FixedVector2 offset);
+
 	//	IRenderable implementation + setters
-	const SDL_Color & GetColor() const override { return color; }
-	__inline void SetColor(SDL_Color newColor) { color = newColor; }
-	__inline void SetColor(Uint8 r, Uint8 g, Uint8 b, Uint8 a = 255) { color.r = r; color.g = g; color.b = b; color.a = a; }
-	const SDL_Rect GetRect() const override;
+	const SDL_Color & GetColor() const override { return world.GetColor(id); }
+	__inline void SetColor(SDL_Color newColor) { world.SetColor(id, newColor); }
+	__inline void SetColor(Uint8 r, Uint8 g, Uint8 b, Uint8 a = 255) { world.SetColor(id, SDL_Color{r, g, b, a}); }
+	const SDL_Rect GetRect() const override { return world.GetRect(id); }
+	__inline const FixedRect GetFixedRect() const { return world.GetFixedRect(id); }
+	void PreRender(SDL_Renderer * r) override;
 	void Render(SDL_Renderer * r) const override;
 private:
-	//	Initialization function with common operations to be called by all constructors
-	void Init();
 	//	Called after Move(), can be overridden in sub-classes to perform checks after movements
 	virtual void PostMoveOperations() { }
 };
-
@@ -0,0 +1,264 @@
+#include "Collision.h"
+
+#pragma region C++ Includes
+#include <cstdlib>
+#include <cstring>
+#pragma endregion
+
+#pragma region SIMD Includes
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define COLLISION_AVX2
+#endif
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define COLLISION_SSE2
+#endif
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#pragma endregion
+
+using namespace std;
+
+int Collision::OverlapMask(const SDL_Rect & rect, const int * xs, const int * ys, const int * ws, const int * hs, int count, Uint32 * hitMask)
+{
+	memset(hitMask, 0, COLLISION_MASK_WORDS(count) * sizeof(Uint32));
+
+	//	An empty rect can't overlap anything
+	if(rect.w <= 0 || rect.h <= 0)
+		return 0;
+
+	/*
+	 * Two rects overlap when they overlap on both axes,
+	 * i.e. when each one starts before the other ends:
+	 *		a.x < b.x + b.w && b.x < a.x + a.w
+	 *		a.y < b.y + b.h && b.y < a.y + a.h
+	 * (and neither of them is empty).
+	 * The same four comparisons are run on as many rects
+	 * as fit in a SIMD register and the results are packed
+	 * into bits with a movemask, so there's no branch per
+	 * rect at all.
+	 * Whatever is left after the SIMD loops is processed
+	 * one rect at a time.
+	 */
+	const int rectRight = rect.x + rect.w;
+	const int rectBottom = rect.y + rect.h;
+	int hits = 0;
+	int i = 0;
+
+#ifdef COLLISION_AVX2
+	{
+		const __m256i zero = _mm256_setzero_si256();
+		const __m256i left = _mm256_set1_epi32(rect.x);
+		const __m256i top = _mm256_set1_epi32(rect.y);
+		const __m256i right = _mm256_set1_epi32(rectRight);
+		const __m256i bottom = _mm256_set1_epi32(rectBottom);
+		for(; i + 8 <= count; i += 8)
+		{
+			const __m256i x = _mm256_loadu_si256((const __m256i *)(xs + i));
+			const __m256i y = _mm256_loadu_si256((const __m256i *)(ys + i));
+			const __m256i w = _mm256_loadu_si256((const __m256i *)(ws + i));
+			const __m256i h = _mm256_loadu_si256((const __m256i *)(hs + i));
+
+			__m256i overlap = _mm256_and_si256(_mm256_cmpgt_epi32(w, zero), _mm256_cmpgt_epi32(h, zero));
+			overlap = _mm256_and_si256(overlap, _mm256_cmpgt_epi32(_mm256_add_epi32(x, w), left));	//	rect.x < x + w
+			overlap = _mm256_and_si256(overlap, _mm256_cmpgt_epi32(right, x));	//	x < rect.x + rect.w
+			overlap = _mm256_and_si256(overlap, _mm256_cmpgt_epi32(_mm256_add_epi32(y, h), top));	//	rect.y < y + h
+			overlap = _mm256_and_si256(overlap, _mm256_cmpgt_epi32(bottom, y));	//	y < rect.y + rect.h
+
+			const Uint32 bits = (Uint32)_mm256_movemask_ps(_mm256_castsi256_ps(overlap));
+			hitMask[i / COLLISION_MASK_BITS] |= bits << (i % COLLISION_MASK_BITS);
+			hits += PopCount(bits);
+		}
+	}
+#endif
+
+#ifdef COLLISION_SSE2
+	{
+		const __m128i zero = _mm_setzero_si128();
+		const __m128i left = _mm_set1_epi32(rect.x);
+		const __m128i top = _mm_set1_epi32(rect.y);
+		const __m128i right = _mm_set1_epi32(rectRight);
+		const __m128i bottom = _mm_set1_epi32(rectBottom);
+		for(; i + 4 <= count; i += 4)
+		{
+			const __m128i x = _mm_loadu_si128((const __m128i *)(xs + i));
+			const __m128i y = _mm_loadu_si128((const __m128i *)(ys + i));
+			const __m128i w = _mm_loadu_si128((const __m128i *)(ws + i));
+			const __m128i h = _mm_loadu_si128((const __m128i *)(hs + i));
+
+			__m128i overlap = _mm_and_si128(_mm_cmpgt_epi32(w, zero), _mm_cmpgt_epi32(h, zero));
+			overlap = _mm_and_si128(overlap, _mm_cmplt_epi32(left, _mm_add_epi32(x, w)));	//	rect.x < x + w
+			overlap = _mm_and_si128(overlap, _mm_cmplt_epi32(x, right));	//	x < rect.x + rect.w
+			overlap = _mm_and_si128(overlap, _mm_cmplt_epi32(top, _mm_add_epi32(y, h)));	//	rect.y < y + h
+			overlap = _mm_and_si128(overlap, _mm_cmplt_epi32(y, bottom));	//	y < rect.y + rect.h
+
+			const Uint32 bits = (Uint32)_mm_movemask_ps(_mm_castsi128_ps(overlap));
+			hitMask[i / COLLISION_MASK_BITS] |= bits << (i % COLLISION_MASK_BITS);
+			hits += PopCount(bits);
+		}
+	}
+#endif
+
+	//	Scalar fallback (and tail of the SIMD loops)
+	for(; i < count; i++)
+	{
+		const bool overlap =
+			ws[i] > 0 && hs[i] > 0 &&
+			rect.x < xs[i] + ws[i] && xs[i] < rectRight &&
+			rect.y < ys[i] + hs[i] && ys[i] < rectBottom;
+		if(overlap)
+		{
+			SetBit(hitMask, i);
+			hits++;
+		}
+	}
+
+	return hits;
+}
+
+int Collision::NextCommonBit(const Uint32 * maskA, int wordsA, const Uint32 * maskB, int wordsB, int from)
+{
+	const int words = wordsA < wordsB ? wordsA : wordsB;
+	for(int word = from / COLLISION_MASK_BITS; word < words; word++)
+	{
+		Uint32 common = maskA[word] & maskB[word];
+		//	Ignore the bits before from in its own word
+		if(word == from / COLLISION_MASK_BITS)
+			common &= ~0u << (from % COLLISION_MASK_BITS);
+		if(common)
+			return word * COLLISION_MASK_BITS + CountTrailingZeros(common);
+	}
+
+	return -1;
+}
+
+SDL_Rect Collision::CoveringPixels(const FixedRect & rect)
+{
+	const int left = FixedFloor(rect.x) - 1;
+	const int top = FixedFloor(rect.y) - 1;
+	const int right = FixedCeil(rect.x + rect.w) + 1;
+	const int bottom = FixedCeil(rect.y + rect.h) + 1;
+	return SDL_Rect{left, top, right - left, bottom - top};
+}
+
+FixedRect Collision::SweptBounds(const FixedRect & rect, Fixed dx, Fixed dy)
+{
+	FixedRect bounds = rect;
+	if(dx < 0)
+		bounds.x += dx;
+	if(dy < 0)
+		bounds.y += dy;
+	bounds.w += dx < 0 ? -dx : dx;
+	bounds.h += dy < 0 ? -dy : dy;
+	return bounds;
+}
+
+bool Collision::Sweep(const FixedRect & rect, Fixed dx, Fixed dy, const FixedRect & other, SweepHit & hit)
+{
+	if(rect.w <= 0 || rect.h <= 0 || other.w <= 0 || other.h <= 0)
+		return false;
+
+	/*
+	 * Slab test: on each axis, the movement enters the
+	 * other rect's extent at some time and exits it at
+	 * a later time (as a fraction of the movement).
+	 * Rects overlap while they overlap on both axes, so
+	 * the contact happens at the latest entry, provided
+	 * it comes before the earliest exit.
+	 * On an axis with no movement, rects either always
+	 * overlap (entry at -infinity, exit at +infinity)
+	 * or never do, which means no contact at all.
+	 * The axis entered last tells the side that's hit.
+	 * Times are fixed point fractions, truncated: equal
+	 * fractions always give equal times. Those too far
+	 * to fit saturate, they're out of [0, 1) anyway.
+	 */
+	Fixed entryX, exitX, entryY, exitY;
+
+	if(dx > 0)
+	{
+		entryX = FixedDiv(other.x - (rect.x + rect.w), dx);
+		exitX = FixedDiv((other.x + other.w) - rect.x, dx);
+	}
+	else if(dx < 0)
+	{
+		entryX = FixedDiv((other.x + other.w) - rect.x, dx);
+		exitX = FixedDiv(other.x - (rect.x + rect.w), dx);
+	}
+	else if(rect.x < other.x + other.w && other.x < rect.x + rect.w)
+	{
+		entryX = FIXED_MIN;
+		exitX = FIXED_MAX;
+	}
+	else
+		return false;
+
+	if(dy > 0)
+	{
+		entryY = FixedDiv(other.y - (rect.y + rect.h), dy);
+		exitY = FixedDiv((other.y + other.h) - rect.y, dy);
+	}
+	else if(dy < 0)
+	{
+		entryY = FixedDiv((other.y + other.h) - rect.y, dy);
+		exitY = FixedDiv(other.y - (rect.y + rect.h), dy);
+	}
+	else if(rect.y < other.y + other.h && other.y < rect.y + rect.h)
+	{
+		entryY = FIXED_MIN;
+		exitY = FIXED_MAX;
+	}
+	else
+		return false;
+
+	const Fixed entry = entryX > entryY ? entryX : entryY;
+	const Fixed exit = exitX < exitY ? exitX : exitY;
+
+	//	No contact during this movement (or already overlapping)
+	if(entry >= exit || entry < 0 || entry >= FIXED_ONE)
+		return false;
+
+	hit.time = entry;
+	//	Ties (corners) are resolved on the X axis
+	if(entryX >= entryY)
+	{
+		hit.normalX = dx > 0 ? -1 : 1;
+		hit.normalY = 0;
+	}
+	else
+	{
+		hit.normalX = 0;
+		hit.normalY = dy > 0 ? -1 : 1;
+	}
+	return true;
+}
+
+int Collision::PopCount(Uint32 value)
+{
+	//	Classic SWAR bit count, portable and branchless
+	value = value - ((value >> 1) & 0x55555555u);
+	value = (value & 0x33333333u) + ((value >> 2) & 0x33333333u);
+	return (int)((((value + (value >> 4)) & 0x0F0F0F0Fu) * 0x01010101u) >> 24);
+}
+
+int Collision::CountTrailingZeros(Uint32 value)
+{
+	//	Value is never 0 here
+#if defined(_MSC_VER)
+	unsigned long index;
+	_BitScanForward(&index, value);
+	return (int)index;
+#elif defined(__GNUC__) || defined(__clang__)
+	return __builtin_ctz(value);
+#else
+	int index = 0;
+	while(!(value & 1u))
+	{
+		value >>= 1;
+		index++;
+	}
+	return index;
+#endif
+}
@@ -0,0 +1,96 @@
+#pragma once
+
+#pragma region SDL Includes
+#include "SDL.h"
+#pragma endregion
+
+#pragma region Engine Includes
+#include "Fixed.h"
+#pragma endregion
+
+//	Hit masks store one bit per tested rect, packed in 32 bit words
+#define COLLISION_MASK_BITS 32
+#define COLLISION_MASK_WORDS(count) (((count) + COLLISION_MASK_BITS - 1) / COLLISION_MASK_BITS)
+
+//	Result of a swept test: when the moving rect touches the other one and which side it hits
+typedef struct
+{
+	Fixed time;	//	Fraction of the movement [0, 1) at which the contact happens
+	int normalX;	//	-1/+1 if the contact is on a vertical side of the other rect, 0 otherwise
+	int normalY;	//	-1/+1 if the contact is on a horizontal side of the other rect, 0 otherwise
+} SweepHit;
+
+/*
+ * A collection of utilities for collision detection
+ * between axis-aligned rects.
+ * The core is a broad-phase test of a single rect
+ * against many rects, given as a structure of arrays
+ * (all x, all y, all w, all h), which checks several
+ * rects per instruction when SIMD is available:
+ * - AVX2: 8 rects at once (requires building with AVX2
+ *		enabled, e.g. /arch:AVX2 or -mavx2)
+ * - SSE2: 4 rects at once (always available on x64)
+ * - scalar fallback everywhere else (e.g. webgl)
+ * All paths give the same results as SDL_HasIntersection().
+ *
+ * For moving rects there's a continuous (swept) test
+ * that finds the time of impact along a movement, so
+ * that fast bodies can't skip through thin ones. It
+ * works on the exact (fixed point) extents of bodies
+ * and uses integer math only, so its results are the
+ * same everywhere.
+ */
+class Collision
+{
+public:
+	//	Same test as SDL_HasIntersection()
+	__inline static bool Overlaps(const SDL_Rect & a, const SDL_Rect & b)
+	{
+		return
+			a.w > 0 && a.h > 0 && b.w > 0 && b.h > 0 &&
+			a.x < b.x + b.w && b.x < a.x + a.w &&
+			a.y < b.y + b.h && b.y < a.y + a.h;
+	}
+	//	Same test on exact extents
+	__inline static bool Overlaps(const FixedRect & a, const FixedRect & b)
+	{
+		return
+			a.w > 0 && a.h > 0 && b.w > 0 && b.h > 0 &&
+			a.x < b.x + b.w && b.x < a.x + a.w &&
+			a.y < b.y + b.h && b.y < a.y + a.h;
+	}
+	/*
+	 * Pixels covering rect, grown by a pixel on each side:
+	 * any rect whose exact extents overlap rect overlaps
+	 * this with its pixel rect (see FixedRect), so it's a
+	 * safe broad-phase test for exact rects.
+	 */
+	static SDL_Rect CoveringPixels(const FixedRect & rect);
+	/*
+	 * Tests rect against count rects and sets bit i of hitMask
+	 * if rect i overlaps, clearing all the others. hitMask must
+	 * hold COLLISION_MASK_WORDS(count) words.
+	 * Returns the number of overlapping rects.
+	 */
+	static int OverlapMask(const SDL_Rect & rect, const int * xs, const int * ys, const int * ws, const int * hs, int count, Uint32 * hitMask);
+	//	Returns the index of the first bit set in both masks, -1 if none
+	__inline static int FirstCommonBit(const Uint32 * maskA, int wordsA, const Uint32 * maskB, int wordsB) { return NextCommonBit(maskA, wordsA, maskB, wordsB, 0); }
+	//	Returns the index of the first bit set in both masks starting from bit from (included), -1 if none
+	static int NextCommonBit(const Uint32 * maskA, int wordsA, const Uint32 * maskB, int wordsB, int from);
+	//	Smallest rect containing rect both before and after moving it by (dx, dy)
+	static FixedRect SweptBounds(const FixedRect & rect, Fixed dx, Fixed dy);
+	/*
+	 * Moves rect by (dx, dy) and checks if, along the way,
+	 * it starts overlapping other. If so, returns true and
+	 * fills hit with the time and side of the contact.
+	 * Rects already overlapping before the movement and
+	 * rects moving away from a touching side don't hit.
+	 */
+	static bool Sweep(const FixedRect & rect, Fixed dx, Fixed dy, const FixedRect & other, SweepHit & hit);
+	__inline static void SetBit(Uint32 * mask, int bit) { mask[bit / COLLISION_MASK_BITS] |= 1u << (bit % COLLISION_MASK_BITS); }
+	__inline static void ClearBit(Uint32 * mask, int bit) { mask[bit / COLLISION_MASK_BITS] &= ~(1u << (bit % COLLISION_MASK_BITS)); }
+	__inline static bool GetBit(const Uint32 * mask, int bit) { return (mask[bit / COLLISION_MASK_BITS] >> (bit % COLLISION_MASK_BITS)) & 1u; }
+private:
+	static int PopCount(Uint32 value);
+	static int CountTrailingZeros(Uint32 value);
+};
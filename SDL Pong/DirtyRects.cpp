@@ -0,0 +1,68 @@
+#include "DirtyRects.h"
+
+void DirtyRects::Enable(int viewportWidth, int viewportHeight)
+{
+	enabled = true;
+	viewport = SDL_Rect{0, 0, viewportWidth, viewportHeight};
+	rects.clear();
+	fullFrame = true;
+}
+
+void DirtyRects::Invalidate(const SDL_Rect & rect)
+{
+	if(!enabled || fullFrame || rect.w <= 0 || rect.h <= 0)
+		return;
+
+	//	Grow by the margin and keep it on screen
+	const SDL_Rect grown{rect.x - DIRTY_RECTS_MARGIN, rect.y - DIRTY_RECTS_MARGIN, rect.w + DIRTY_RECTS_MARGIN * 2, rect.h + DIRTY_RECTS_MARGIN * 2};
+	SDL_Rect region;
+	if(!SDL_IntersectRect(&grown, &viewport, &region))
+		return;
+
+	/*
+	 * Merge the region with all those it touches. A merge
+	 * makes the region bigger, so it can touch regions it
+	 * didn't before: keep going until none is touched.
+	 */
+	bool merged = true;
+	while(merged)
+	{
+		merged = false;
+		for(size_t i = 0; i < rects.size(); i++)
+			if(SDL_HasIntersection(&rects[i], &region))
+			{
+				SDL_UnionRect(&rects[i], &region, &region);
+				rects[i] = rects.back();
+				rects.pop_back();
+				merged = true;
+				break;
+			}
+	}
+	rects.push_back(region);
+
+	if(
+		rects.size() > DIRTY_RECTS_MAX_COUNT ||
+		GetCoveredArea() * 100 > (long long)viewport.w * viewport.h * DIRTY_RECTS_MAX_COVERAGE
+		)
+		InvalidateAll();
+}
+
+void DirtyRects::InvalidateAll()
+{
+	fullFrame = true;
+	rects.clear();
+}
+
+void DirtyRects::Clear()
+{
+	fullFrame = false;
+	rects.clear();
+}
+
+long long DirtyRects::GetCoveredArea() const
+{
+	long long area = 0;
+	for(const SDL_Rect & rect : rects)
+		area += (long long)rect.w * rect.h;
+	return area;
+}
@@ -0,0 +1,80 @@
+#pragma once
+
+#pragma region C++ Includes
+#include <vector>
+#pragma endregion
+
+#pragma region SDL Includes
+#include "SDL.h"
+#pragma endregion
+
+using namespace std;
+
+//	Past these limits, redrawing the whole frame is cheaper than redrawing the regions one by one
+#define DIRTY_RECTS_MAX_COUNT 16
+#define DIRTY_RECTS_MAX_COVERAGE 50	//	Percentage of the viewport
+#define DIRTY_RECTS_MARGIN 2	//	Pixels added around each region, for edges drawn past the rects (e.g. glyphs)
+
+/*
+ * Keeps track of the regions of the screen that changed
+ * since the last frame, so that only those are drawn
+ * and presented.
+ * This only pays off when the back buffer survives the
+ * present, which is the case of the software renderer
+ * (it draws on the window surface, which is persistent)
+ * and where filling pixels is what costs the most: a
+ * Pong frame changes the ball, the paddles and now and
+ * then a score, a small part of the screen.
+ * Renderables report where they were and where they are
+ * when they change (in their pre-render), regions that
+ * touch are merged and, when there are too many or they
+ * cover too much of the screen, the whole frame is
+ * redrawn instead.
+ * While disabled (accelerated renderers) every frame
+ * is a full frame.
+ */
+class DirtyRects
+{
+	// Fields
+public:
+protected:
+private:
+	bool enabled = false;
+	SDL_Rect viewport{0, 0, 0, 0};
+	vector<SDL_Rect> rects;	//	Changed regions of the current frame, not overlapping each other
+	bool fullFrame = true;
+	// Constructors
+public:
+	// Delete copy constructor and assignment operator (singleton protection)
+	DirtyRects(const DirtyRects &) = delete;
+	DirtyRects & operator=(const DirtyRects &) = delete;
+protected:
+private:
+	DirtyRects() { }
+	// Methods
+public:
+	static DirtyRects & Get()
+	{
+		//	Singleton implementation
+		static DirtyRects instance;
+		return instance;
+	}
+	//	Starts tracking changes on a viewport of the given size, the first frame is a full one
+	void Enable(int viewportWidth, int viewportHeight);
+	__inline bool IsEnabled() const { return enabled; }
+
+	//	Marks a region as changed
+	void Invalidate(const SDL_Rect & rect);
+	//	Marks the whole viewport as changed (e.g. the window has been exposed)
+	void InvalidateAll();
+
+	//	True when the whole frame must be drawn, false when only the regions returned by GetRects() changed
+	__inline bool IsFullFrame() const { return fullFrame || !enabled; }
+	__inline const vector<SDL_Rect> & GetRects() const { return rects; }
+	//	Starts a new frame with no changes, call after presenting
+	void Clear();
+protected:
+private:
+	//	Area of all regions, in pixels (they don't overlap)
+	long long GetCoveredArea() const;
+};
@@ -0,0 +1,78 @@
+#pragma once
+
+#pragma region C++ Includes
+#include <cmath>
+#pragma endregion
+
+#pragma region SDL Includes
+#include "SDL_stdinc.h"
+#include "SDL_rect.h"
+#pragma endregion
+
+/*
+ * Fixed-point numbers used by the simulation, in 16.16
+ * format: the high 16 bits are the integer part, the
+ * low 16 bits the fraction (1 / 65536 of a pixel), so
+ * bodies can move by fractions of a pixel.
+ * Unlike floats, integer operations give the very same
+ * result on every compiler, architecture and build
+ * option, so a simulation only made of these (given
+ * the same inputs) is bit-identical everywhere, which
+ * is what lockstep play and reproducible runs need.
+ * Floats only come in when setting things up (e.g. a
+ * pivot of 0.5), converted once with exact rounding.
+ * NOTE: right shifts of negative values are arithmetic
+ * on every supported compiler (and required to be so
+ * since C++20), they round towards negative infinity.
+ */
+typedef Sint32 Fixed;
+
+#define FIXED_SHIFT 16
+#define FIXED_ONE (1 << FIXED_SHIFT)
+#define FIXED_HALF (1 << (FIXED_SHIFT - 1))
+#define FIXED_FRACTION_MASK (FIXED_ONE - 1)
+#define FIXED_MAX ((Fixed)0x7FFFFFFF)
+#define FIXED_MIN ((Fixed)-0x7FFFFFFF - 1)
+
+__inline Fixed FixedFromInt(int value) { return (Fixed)((Uint32)value << FIXED_SHIFT); }
+//	Rounds to the nearest fixed value, for set up only
+__inline Fixed FixedFromFloat(float value) { return (Fixed)lround((double)value * FIXED_ONE); }
+//	Largest integer not greater than the value
+__inline int FixedFloor(Fixed value) { return value >> FIXED_SHIFT; }
+//	Smallest integer not less than the value
+__inline int FixedCeil(Fixed value) { return (Fixed)(((Sint64)value + FIXED_FRACTION_MASK) >> FIXED_SHIFT); }
+//	Nearest integer, halves go up
+__inline int FixedRound(Fixed value) { return (Fixed)(((Sint64)value + FIXED_HALF) >> FIXED_SHIFT); }
+//	For rendering and reports, never for the simulation
+__inline float FixedToFloat(Fixed value) { return value / (float)FIXED_ONE; }
+__inline Fixed FixedAbs(Fixed value) { return value < 0 ? -value : value; }
+__inline Fixed FixedMin(Fixed a, Fixed b) { return a < b ? a : b; }
+__inline Fixed FixedMax(Fixed a, Fixed b) { return a > b ? a : b; }
+__inline Fixed FixedClamp(Fixed value, Fixed min, Fixed max) { return FixedMin(FixedMax(value, min), max); }
+__inline Fixed FixedMul(Fixed a, Fixed b) { return (Fixed)((Sint64)a * b >> FIXED_SHIFT); }
+//	Truncates towards 0, saturates when the result doesn't fit (b must not be 0)
+__inline Fixed FixedDiv(Fixed a, Fixed b)
+{
+	const Sint64 quotient = (Sint64)a * FIXED_ONE / b;
+	return quotient > FIXED_MAX ? FIXED_MAX : (quotient < FIXED_MIN ? FIXED_MIN : (Fixed)quotient);
+}
+
+//	2D Vector type in fixed point, used for positions and velocities of the simulation
+typedef struct FixedVector2
+{
+	Fixed x;
+	Fixed y;
+
+	FixedVector2(Fixed xVal, Fixed yVal) : x(xVal), y(yVal) { }
+} FixedVector2;
+
+//	Rect in fixed point, the exact extents of a body (its pixels are SDL_Rect{floor(x), floor(y), w, h})
+typedef struct
+{
+	Fixed x;
+	Fixed y;
+	Fixed w;
+	Fixed h;
+} FixedRect;
+
+__inline FixedRect FixedRectFromRect(const SDL_Rect & rect) { return FixedRect{FixedFromInt(rect.x), FixedFromInt(rect.y), FixedFromInt(rect.w), FixedFromInt(rect.h)}; }
@@ -0,0 +1,139 @@
+#include "FontCache.h"
+
+#pragma region C++ Includes
+#include <iostream>
+#pragma endregion
+
+#pragma region Engine Includes
+#include "ResourceArchive.h"
+#pragma endregion
+
+TTF_Font * FontCache::Acquire(const string & path, int pointSize)
+{
+	lock_guard<mutex> lock(access);
+
+	const FontKey key(path, pointSize);
+	auto cached = fonts.find(key);
+	if(cached != fonts.end())
+	{
+		//	Open already, just take it out of the eviction list if nobody was using it
+		if(cached->second.references == 0)
+			unused.erase(cached->second.unusedPosition);
+		cached->second.references++;
+		hits++;
+		return cached->second.font;
+	}
+	misses++;
+
+	//	Read the file only if no other size of the same font did it already (fonts in the archive need no reading)
+	auto file = files.find(path);
+	if(file == files.end())
+	{
+		const void * data = nullptr;
+		size_t size = 0;
+		bool owned = false;
+		if(!ResourceArchive::Get().Find(path, data, size))
+		{
+			data = SDL_LoadFile(path.c_str(), &size);
+			owned = true;
+		}
+		if(!data)
+		{
+			cout << "Couldn't read font \"" << path << "\": " << SDL_GetError() << endl;
+			return nullptr;
+		}
+		file = files.insert(make_pair(path, FontFile{data, size, owned, 0})).first;
+		if(owned)
+			memoryUsed += size;
+	}
+
+	//	The font keeps reading glyphs from the data, which stays alive while any font uses it
+	TTF_Font * font = TTF_OpenFontRW(SDL_RWFromConstMem(file->second.data, (int)file->second.size), 1, pointSize);
+	if(!font)
+	{
+		cout << "Couldn't load font \"" << path << "\" with size " << pointSize << ": " << TTF_GetError() << endl;
+		if(file->second.faces == 0)
+			FreeFile(file);
+		return nullptr;
+	}
+	file->second.faces++;
+	memoryUsed += FONT_CACHE_FACE_COST;
+	fonts.insert(make_pair(key, FontEntry{font, 1, unused.end()}));
+
+	//	Adding a font may push unused ones out
+	EvictOverBudget();
+
+	return font;
+}
+
+void FontCache::Release(const string & path, int pointSize)
+{
+	lock_guard<mutex> lock(access);
+
+	auto cached = fonts.find(FontKey(path, pointSize));
+	if(cached == fonts.end() || cached->second.references == 0)
+		return;
+
+	//	Unused fonts stay open, most recent first, until the budget is exceeded
+	if(--cached->second.references == 0)
+	{
+		unused.push_front(cached->first);
+		cached->second.unusedPosition = unused.begin();
+		EvictOverBudget();
+	}
+}
+
+void FontCache::Clear()
+{
+	lock_guard<mutex> lock(access);
+
+	while(!fonts.empty())
+		Close(fonts.begin());
+	unused.clear();
+}
+
+void FontCache::PrintReport() const
+{
+	lock_guard<mutex> lock(access);
+
+	const Uint64 requests = hits + misses;
+	if(requests == 0)
+		return;
+
+	cout << "Font cache: " << requests << " requests, " << hits << " hits (" << hits * 100.0 / requests << "%), " << misses << " misses" << endl;
+	cout << "  Memory: " << memoryUsed / 1024.0 << "KB of " << FONT_CACHE_BUDGET / 1024 << "KB for " << fonts.size() << " open fonts" << endl;
+}
+
+void FontCache::EvictOverBudget()
+{
+	//	Least recently released fonts go first, fonts in use are never closed
+	while(memoryUsed > FONT_CACHE_BUDGET && !unused.empty())
+	{
+		const FontKey key = unused.back();
+		unused.pop_back();
+		Close(fonts.find(key));
+	}
+}
+
+void FontCache::Close(map<FontKey, FontEntry>::iterator entry)
+{
+	TTF_CloseFont(entry->second.font);
+	memoryUsed -= FONT_CACHE_FACE_COST;
+
+	//	Free the file data with the last font reading from it
+	auto file = files.find(entry->first.first);
+	if(file != files.end() && --file->second.faces == 0)
+		FreeFile(file);
+
+	fonts.erase(entry);
+}
+
+void FontCache::FreeFile(map<string, FontFile>::iterator file)
+{
+	if(file->second.owned)
+	{
+		memoryUsed -= file->second.size;
+		SDL_free((void *)file->second.data);
+	}
+	files.erase(file);
+}
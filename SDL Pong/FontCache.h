@@ -0,0 +1,99 @@
+#pragma once
+
+#pragma region C++ Includes
+#include <string>
+#include <map>
+#include <list>
+#include <mutex>
+#pragma endregion
+
+#pragma region SDL Includes
+#include "SDL.h"
+#include "SDL_ttf.h"
+#pragma endregion
+
+using namespace std;
+
+//	Memory the cache may use for fonts nobody is using (fonts in use are never evicted)
+#define FONT_CACHE_BUDGET (4 * 1024 * 1024)
+//	Rough cost of an open face on top of the file data (FreeType face, size and glyph caches)
+#define FONT_CACHE_FACE_COST (64 * 1024)
+
+/*
+ * Keeps fonts open, so that the same font file isn't
+ * read and parsed each time some text needs it.
+ * Fonts are identified by path and point size, each
+ * file is read from disk once (or not at all, when
+ * it's in the resource archive) and all its sizes
+ * are opened from the same bytes in memory.
+ * Fonts are reference counted: Acquire() returns an
+ * open font (opening it only if needed) and every
+ * Acquire() must be matched by a Release(). Released
+ * fonts stay open, ready for the next request, until
+ * the memory used by the cache exceeds its budget:
+ * then the least recently released ones are closed
+ * (and their file data freed, when no other size
+ * uses it).
+ * Access is synchronized, fonts can be acquired from
+ * any thread (but SDL_ttf calls on the same font must
+ * not overlap).
+ */
+class FontCache
+{
+	// Fields
+public:
+protected:
+private:
+	typedef pair<string, int> FontKey;
+	typedef struct
+	{
+		const void * data;	//	Contents of the font file, fonts read from here
+		size_t size;
+		bool owned;	//	False when the data is in the resource archive
+		int faces;	//	Open fonts using the data
+	} FontFile;
+	typedef struct
+	{
+		TTF_Font * font;
+		int references;
+		list<FontKey>::iterator unusedPosition;	//	Place in the eviction list, when not referenced
+	} FontEntry;
+
+	map<string, FontFile> files;
+	map<FontKey, FontEntry> fonts;
+	list<FontKey> unused;	//	Fonts with no references, most recently released first
+	size_t memoryUsed = 0;
+	//	Statistics
+	Uint64 hits = 0;
+	Uint64 misses = 0;
+	mutable mutex access;
+	// Constructors
+public:
+	// Delete copy constructor and assignment operator (singleton protection)
+	FontCache(const FontCache &) = delete;
+	FontCache & operator=(const FontCache &) = delete;
+protected:
+private:
+	FontCache() { }
+	// Methods
+public:
+	static FontCache & Get()
+	{
+		//	Singleton implementation
+		static FontCache instance;
+		return instance;
+	}
+	//	Returns the font at path with the given size, nullptr if it can't be loaded, Release() it when done
+	TTF_Font * Acquire(const string & path, int pointSize);
+	void Release(const string & path, int pointSize);
+	//	Closes all fonts, call before TTF_Quit()
+	void Clear();
+	//	Prints how often fonts were found open and the memory they use
+	void PrintReport() const;
+protected:
+private:
+	//	All expect the lock to be held
+	void EvictOverBudget();
+	void Close(map<FontKey, FontEntry>::iterator entry);
+	void FreeFile(map<string, FontFile>::iterator file);
+};
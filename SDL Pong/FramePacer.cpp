@@ -0,0 +1,126 @@
+#include "FramePacer.h"
+
+#pragma region C++ Includes
+#include <iostream>
+#pragma endregion
+
+using namespace std;
+
+FramePacer::FramePacer(int targetFps) :
+	frequency(SDL_GetPerformanceFrequency()),
+	targetFps(targetFps > 0 ? targetFps : 60),
+	baseTime(SDL_GetPerformanceCounter()),
+	spinTicks(MicrosToTicks(FRAME_PACER_DEFAULT_SPIN_US))
+{ }
+
+void FramePacer::Wait()
+{
+	const Uint64 deadline = GetDeadline(frameIndex + 1);
+	Uint64 now = SDL_GetPerformanceCounter();
+
+	//	The frame took too long, no wait
+	if(now >= deadline)
+	{
+		missedFrames++;
+		RecordError(now - deadline);
+
+		/*
+		 * If the frame is late by more than a whole frame
+		 * time, the missed deadlines are gone for good:
+		 * restart from now instead of rushing through the
+		 * next frames to catch up with them.
+		 */
+		if(now >= GetDeadline(frameIndex + 2))
+		{
+			baseTime = now;
+			frameIndex = 0;
+		}
+		else
+			frameIndex++;
+		return;
+	}
+
+	//	Coarse sleep, up to the spin margin
+	if(deadline - now > spinTicks)
+	{
+		const Uint32 sleepMillis = (Uint32)((deadline - now - spinTicks) * 1000 / frequency);
+		if(sleepMillis > 0)
+		{
+			const Uint64 sleepStart = now;
+			SDL_Delay(sleepMillis);
+			now = SDL_GetPerformanceCounter();
+
+			/*
+			 * Learn how late the OS wakes us up: the margin grows
+			 * immediately to the worst oversleep seen, and slowly
+			 * shrinks back when sleeps get more accurate.
+			 */
+			const Uint64 requested = MicrosToTicks((Uint64)sleepMillis * 1000);
+			const Uint64 slept = now - sleepStart;
+			const Uint64 oversleep = slept > requested ? slept - requested : 0;
+			const Uint64 minSpinTicks = MicrosToTicks(FRAME_PACER_MIN_SPIN_US);
+			if(oversleep > spinTicks)
+				spinTicks = oversleep;
+			else
+				spinTicks -= (spinTicks - oversleep) / 64;
+			if(spinTicks < minSpinTicks)
+				spinTicks = minSpinTicks;
+		}
+	}
+
+	//	Fine wait, spin on the counter for the last fraction
+	const Uint64 spinStart = now;
+	while(now < deadline)
+	{
+		SDL_CPUPauseInstruction();
+		now = SDL_GetPerformanceCounter();
+	}
+	totalSpinTicks += now - spinStart;
+
+	pacedFrames++;
+	RecordError(now - deadline);
+	frameIndex++;
+}
+
+void FramePacer::PrintReport() const
+{
+	const Uint64 frames = pacedFrames + missedFrames;
+	if(frames == 0)
+		return;
+
+	const int bounds[] = FRAME_PACER_BUCKET_BOUNDS;
+
+	cout << "Frame pacing at " << targetFps << "fps over " << frames << " frames (" << missedFrames << " missed)" << endl;
+	cout << "  Error: mean " << TicksToMicros(totalErrorTicks) / (double)frames << "us, max " << TicksToMicros(maxErrorTicks) << "us" << endl;
+	if(pacedFrames > 0)
+		cout << "  Spin: mean " << TicksToMicros(totalSpinTicks) / (double)pacedFrames << "us, margin " << TicksToMicros(spinTicks) << "us" << endl;
+	for(int bucket = 0; bucket < FRAME_PACER_BUCKETS; bucket++)
+	{
+		if(bucket < FRAME_PACER_BUCKETS - 1)
+			cout << "  < " << bounds[bucket] << "us";
+		else
+			cout << "  >= " << bounds[bucket - 1] << "us";
+		cout << ": " << buckets[bucket] << " (" << buckets[bucket] * 100.0 / frames << "%)" << endl;
+	}
+}
+
+Uint64 FramePacer::GetDeadline(Uint64 frame) const
+{
+	//	Computed from the base every time, so the fractional part of the frame time is never lost
+	return baseTime + frame * frequency / targetFps;
+}
+
+void FramePacer::RecordError(Uint64 errorTicks)
+{
+	const int bounds[] = FRAME_PACER_BUCKET_BOUNDS;
+	const Uint64 errorMicros = TicksToMicros(errorTicks);
+
+	int bucket = 0;
+	while(bucket < FRAME_PACER_BUCKETS - 1 && errorMicros >= (Uint64)bounds[bucket])
+		bucket++;
+	buckets[bucket]++;
+
+	totalErrorTicks += errorTicks;
+	if(errorTicks > maxErrorTicks)
+		maxErrorTicks = errorTicks;
+}
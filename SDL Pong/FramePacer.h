@@ -0,0 +1,68 @@
+#pragma once
+
+#pragma region SDL Includes
+#include "SDL.h"
+#pragma endregion
+
+//	Pacing error histogram, upper bounds (in microseconds) of the buckets, the last one takes everything above
+#define FRAME_PACER_BUCKETS 9
+#define FRAME_PACER_BUCKET_BOUNDS { 10, 25, 50, 100, 250, 500, 1000, 2000, 0 }
+//	Initial time reserved for spinning before a deadline, adapted to the actual sleep accuracy
+#define FRAME_PACER_DEFAULT_SPIN_US 2000
+#define FRAME_PACER_MIN_SPIN_US 500
+
+/*
+ * Keeps a steady frame rate by waiting, at the end
+ * of each frame, for the frame's deadline.
+ * Deadlines are absolute (the n-th frame ends at
+ * start + n * frame time, measured with the high
+ * resolution performance counter), so rounding and
+ * late frames don't accumulate into drift, and the
+ * frame time doesn't need to be a whole number of
+ * milliseconds (e.g. 16.67ms at 60fps).
+ * The OS can only sleep with a coarse granularity
+ * and wakes threads up late by a variable amount,
+ * so the wait is split in two parts: a sleep that
+ * ends a safety margin before the deadline and a
+ * busy wait (spin) for the rest. The margin follows
+ * the worst oversleep observed, so the CPU spins as
+ * little as possible.
+ * How far from the deadline each frame actually ends
+ * is collected in a histogram, printed on request.
+ */
+class FramePacer
+{
+	// Fields
+public:
+protected:
+private:
+	const Uint64 frequency;	//	Performance counter ticks per second
+	const int targetFps;
+	Uint64 baseTime;	//	Counter value deadlines are computed from
+	Uint64 frameIndex = 0;	//	Frames since baseTime
+	Uint64 spinTicks;	//	Margin left to spinning before each deadline
+	//	Statistics
+	Uint64 buckets[FRAME_PACER_BUCKETS] = { };
+	Uint64 pacedFrames = 0;
+	Uint64 missedFrames = 0;	//	Frames that ended past their deadline on their own
+	Uint64 totalErrorTicks = 0;
+	Uint64 maxErrorTicks = 0;
+	Uint64 totalSpinTicks = 0;
+	// Constructors
+public:
+	FramePacer(int targetFps);
+protected:
+private:
+	// Methods
+public:
+	//	Waits for the current frame's deadline, call once at the end of each frame
+	void Wait();
+	//	Prints the pacing statistics collected so far
+	void PrintReport() const;
+protected:
+private:
+	Uint64 GetDeadline(Uint64 frame) const;
+	void RecordError(Uint64 errorTicks);
+	__inline Uint64 TicksToMicros(Uint64 ticks) const { return ticks * 1000000 / frequency; }
+	__inline Uint64 MicrosToTicks(Uint64 micros) const { return micros * frequency / 1000000; }
+};
@@ -0,0 +1,216 @@
+#include "FrameProfiler.h"
+
+#pragma region C++ Includes
+#include <algorithm>
+#include <vector>
+#include <fstream>
+#include <iostream>
+#include <iomanip>
+#include <cstring>
+#pragma endregion
+
+using namespace std;
+
+FrameProfiler::FrameProfiler() :
+	frequency(SDL_GetPerformanceFrequency()),
+	publishedFrames(0),
+	pendingTicks(0)
+{
+	memset(samples, 0, sizeof(samples));
+	memset(&current, 0, sizeof(current));
+	memset(reportedStart, 0, sizeof(reportedStart));
+	memset(reportedEnd, 0, sizeof(reportedEnd));
+}
+
+void FrameProfiler::BeginFrame()
+{
+	//	Stages that don't run in this frame will have no duration
+	memset(&current, 0, sizeof(current));
+	current.frameStart = SDL_GetPerformanceCounter();
+}
+
+void FrameProfiler::EndFrame()
+{
+	current.frameEnd = SDL_GetPerformanceCounter();
+	current.ticks += pendingTicks.exchange(0, memory_order_relaxed);
+
+	//	Stages reported by other threads since the last frame
+	{
+		lock_guard<mutex> lock(reportedMutex);
+		for(int stage = 0; stage < PS_Count; stage++)
+			if(reportedEnd[stage] != 0)
+			{
+				current.stageStart[stage] = reportedStart[stage];
+				current.stageEnd[stage] = reportedEnd[stage];
+				reportedStart[stage] = 0;
+				reportedEnd[stage] = 0;
+			}
+	}
+
+	//	Write the frame in the next slot, then publish it (the release makes the slot visible to readers before the counter)
+	const Uint64 frame = publishedFrames.load(memory_order_relaxed);
+	samples[frame % FRAME_PROFILER_CAPACITY] = current;
+	publishedFrames.store(frame + 1, memory_order_release);
+}
+
+void FrameProfiler::ReportStage(ProfilerStage stage, Uint64 start, Uint64 end)
+{
+	lock_guard<mutex> lock(reportedMutex);
+	reportedStart[stage] = start;
+	reportedEnd[stage] = end;
+}
+
+double FrameProfiler::GetStagePercentile(ProfilerStage stage, double percentile, int lastFrames) const
+{
+	return GetPercentile(stage, percentile, lastFrames);
+}
+
+double FrameProfiler::GetFramePercentile(double percentile, int lastFrames) const
+{
+	return GetPercentile(PS_Count, percentile, lastFrames);
+}
+
+void FrameProfiler::GetRates(int lastFrames, double & framesPerSecond, double & ticksPerSecond) const
+{
+	framesPerSecond = 0.0;
+	ticksPerSecond = 0.0;
+
+	const Uint64 published = GetFrameCount();
+	Uint64 count = published < FRAME_PROFILER_CAPACITY ? published : FRAME_PROFILER_CAPACITY;
+	if(lastFrames > 0 && (Uint64)lastFrames < count)
+		count = lastFrames;
+	if(count == 0)
+		return;
+
+	//	Rates over the time span from the start of the oldest frame to the end of the newest one
+	Uint64 ticks = 0;
+	for(Uint64 i = 0; i < count; i++)
+		ticks += samples[(published - 1 - i) % FRAME_PROFILER_CAPACITY].ticks;
+	const Uint64 spanStart = samples[(published - count) % FRAME_PROFILER_CAPACITY].frameStart;
+	const Uint64 spanEnd = samples[(published - 1) % FRAME_PROFILER_CAPACITY].frameEnd;
+	if(spanEnd <= spanStart)
+		return;
+
+	const double seconds = (double)(spanEnd - spanStart) / frequency;
+	framesPerSecond = count / seconds;
+	ticksPerSecond = ticks / seconds;
+}
+
+const char * FrameProfiler::GetStageName(ProfilerStage stage)
+{
+	switch(stage)
+	{
+		case PS_Events:
+			return "Events";
+		case PS_Update:
+			return "Update";
+		case PS_PreRender:
+			return "PreRender";
+		case PS_Render:
+			return "Render";
+		case PS_Present:
+			return "Present";
+		case PS_Pacing:
+			return "Pacing";
+		default:
+			return "Frame";
+	}
+}
+
+void FrameProfiler::PrintReport() const
+{
+	const Uint64 published = GetFrameCount();
+	if(published == 0)
+		return;
+
+	const Uint64 frames = published < FRAME_PROFILER_CAPACITY ? published : FRAME_PROFILER_CAPACITY;
+	const ios_base::fmtflags flags = cout.flags();
+	const streamsize precision = cout.precision();
+	cout << "Frame profile over the last " << frames << " frames (p50 / p95 / p99 in ms)" << endl;
+	cout << fixed << setprecision(3);
+	for(int stage = 0; stage <= PS_Count; stage++)
+		cout
+			<< "  " << setw(10) << left << GetStageName((ProfilerStage)stage) << right
+			<< GetPercentile(stage, 50.0, FRAME_PROFILER_CAPACITY) << " / "
+			<< GetPercentile(stage, 95.0, FRAME_PROFILER_CAPACITY) << " / "
+			<< GetPercentile(stage, 99.0, FRAME_PROFILER_CAPACITY) << endl;
+	cout.flags(flags);
+	cout.precision(precision);
+}
+
+bool FrameProfiler::DumpChromeTrace(const string & path) const
+{
+	const Uint64 published = GetFrameCount();
+	const Uint64 frames = published < FRAME_PROFILER_CAPACITY ? published : FRAME_PROFILER_CAPACITY;
+	if(frames == 0)
+		return false;
+
+	ofstream trace(path);
+	if(!trace)
+	{
+		cout << "Couldn't open trace file " << path << endl;
+		return false;
+	}
+
+	/*
+	 * The Chrome trace format is a list of events, here
+	 * all of them are "complete" events (ph X), with a
+	 * start and a duration in microseconds. Stages are
+	 * nested in their frame by time, so the viewer shows
+	 * them as children of the frame event.
+	 */
+	const Uint64 firstFrame = published - frames;
+	const Uint64 origin = samples[firstFrame % FRAME_PROFILER_CAPACITY].frameStart;
+	bool first = true;
+	auto writeEvent = [&](const char * name, Uint64 start, Uint64 end, int ticks)
+	{
+		trace << (first ? "\n" : ",\n");
+		first = false;
+		trace
+			<< "{\"name\":\"" << name << "\",\"cat\":\"frame\",\"ph\":\"X\",\"pid\":1,\"tid\":1"
+			<< ",\"ts\":" << TicksToMillis(start - origin) * 1000.0
+			<< ",\"dur\":" << TicksToMillis(end - start) * 1000.0;
+		if(ticks >= 0)
+			trace << ",\"args\":{\"ticks\":" << ticks << "}";
+		trace << "}";
+	};
+
+	trace << fixed << setprecision(3);
+	trace << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+	for(Uint64 frame = firstFrame; frame < published; frame++)
+	{
+		const FrameSample & sample = samples[frame % FRAME_PROFILER_CAPACITY];
+		writeEvent("Frame", sample.frameStart, sample.frameEnd, sample.ticks);
+		for(int stage = 0; stage < PS_Count; stage++)
+			if(sample.stageEnd[stage] > sample.stageStart[stage])
+				writeEvent(GetStageName((ProfilerStage)stage), sample.stageStart[stage], sample.stageEnd[stage], -1);
+	}
+	trace << "\n]}\n";
+
+	return (bool)trace;
+}
+
+double FrameProfiler::GetPercentile(int stage, double percentile, int lastFrames) const
+{
+	const Uint64 published = GetFrameCount();
+	Uint64 count = published < FRAME_PROFILER_CAPACITY ? published : FRAME_PROFILER_CAPACITY;
+	if(lastFrames > 0 && (Uint64)lastFrames < count)
+		count = lastFrames;
+	if(count == 0)
+		return 0.0;
+
+	//	Collect durations of the most recent frames (stage PS_Count stands for the whole frame)
+	vector<Uint64> durations((size_t)count);
+	for(Uint64 i = 0; i < count; i++)
+	{
+		const FrameSample & sample = samples[(published - 1 - i) % FRAME_PROFILER_CAPACITY];
+		durations[(size_t)i] = stage == PS_Count ?
+			sample.frameEnd - sample.frameStart :
+			sample.stageEnd[stage] - sample.stageStart[stage];
+	}
+
+	//	Nearest-rank percentile, partial sort is enough
+	const size_t index = (size_t)(percentile / 100.0 * (count - 1) + 0.5);
+	nth_element(durations.begin(), durations.begin() + index, durations.end());
+	return TicksToMillis(durations[index]);
+}
@@ -0,0 +1,114 @@
+#pragma once
+
+#pragma region C++ Includes
+#include <atomic>
+#include <mutex>
+#include <string>
+#pragma endregion
+
+#pragma region SDL Includes
+#include "SDL.h"
+#pragma endregion
+
+using namespace std;
+
+//	Number of frames kept in memory, older frames are overwritten
+#define FRAME_PROFILER_CAPACITY 4096
+
+//	Stages of a frame of the main loop, in order
+typedef enum
+{
+	PS_Events		= 0,
+	PS_Update		= 1,
+	PS_PreRender	= 2,
+	PS_Render		= 3,
+	PS_Present		= 4,
+	PS_Pacing		= 5,
+	PS_Count		= 6
+} ProfilerStage;
+
+//	Timings of a single frame, in performance counter ticks
+typedef struct
+{
+	Uint64 frameStart;
+	Uint64 frameEnd;
+	Uint64 stageStart[PS_Count];
+	Uint64 stageEnd[PS_Count];
+	int ticks;	//	Simulation ticks run during the frame
+} FrameSample;
+
+/*
+ * Measures how long each stage of each frame takes.
+ * Every frame is a record of timestamps written into
+ * a ring buffer: the render loop (the only writer) fills
+ * the next slot and then publishes it by advancing an
+ * atomic counter, so readers (e.g. the overlay) never
+ * need a lock, they only look at published frames.
+ * When the simulation runs on another thread, it
+ * reports its stages and ticks on its own; the latest
+ * ones are added to the frame being recorded when it
+ * ends.
+ * From the frames in the buffer it computes rolling
+ * percentiles and, on request, writes them as a trace
+ * that can be opened in chrome://tracing (or Perfetto).
+ */
+class FrameProfiler
+{
+	// Fields
+public:
+protected:
+private:
+	const Uint64 frequency;	//	Performance counter ticks per second
+	FrameSample samples[FRAME_PROFILER_CAPACITY];
+	FrameSample current;	//	Frame being recorded
+	atomic<Uint64> publishedFrames;	//	Frames written so far, the last one is at (publishedFrames - 1) % capacity
+	//	Reported by other threads, taken at the end of the frame
+	atomic<int> pendingTicks;
+	mutex reportedMutex;
+	Uint64 reportedStart[PS_Count];
+	Uint64 reportedEnd[PS_Count];
+	// Constructors
+public:
+	// Delete copy constructor and assignment operator (singleton protection)
+	FrameProfiler(const FrameProfiler &) = delete;
+	FrameProfiler & operator=(const FrameProfiler &) = delete;
+protected:
+private:
+	FrameProfiler();
+	// Methods
+public:
+	static FrameProfiler & Get()
+	{
+		//	Singleton implementation
+		static FrameProfiler instance;
+		return instance;
+	}
+	//	Frame recording, call from the render loop only
+	void BeginFrame();
+	__inline void BeginStage(ProfilerStage stage) { current.stageStart[stage] = SDL_GetPerformanceCounter(); }
+	__inline void EndStage(ProfilerStage stage) { current.stageEnd[stage] = SDL_GetPerformanceCounter(); }
+	void EndFrame();
+	//	Can be called from any thread
+	__inline void AddTicks(int ticks) { pendingTicks.fetch_add(ticks, memory_order_relaxed); }
+	//	Reports a stage run on another thread (performance counter values), the latest one goes in the current frame
+	void ReportStage(ProfilerStage stage, Uint64 start, Uint64 end);
+
+	//	Statistics over the last frames recorded (at most the capacity)
+	__inline Uint64 GetFrameCount() const { return publishedFrames.load(memory_order_acquire); }
+	//	Percentile (0-100) of a stage's duration, in milliseconds
+	double GetStagePercentile(ProfilerStage stage, double percentile, int lastFrames = FRAME_PROFILER_CAPACITY) const;
+	//	Percentile (0-100) of the whole frame's duration, in milliseconds
+	double GetFramePercentile(double percentile, int lastFrames = FRAME_PROFILER_CAPACITY) const;
+	//	Frames and simulation ticks per second over the last frames
+	void GetRates(int lastFrames, double & framesPerSecond, double & ticksPerSecond) const;
+	__inline double TicksToMillis(Uint64 ticks) const { return ticks * 1000.0 / frequency; }
+	static const char * GetStageName(ProfilerStage stage);
+
+	//	Prints p50/p95/p99 of each stage
+	void PrintReport() const;
+	//	Writes the frames recorded as a Chrome trace (JSON), returns false on failure
+	bool DumpChromeTrace(const string & path) const;
+protected:
+private:
+	double GetPercentile(int stage, double percentile, int lastFrames) const;
+};
@@ -0,0 +1,196 @@
+#include "GlyphAtlas.h"
+
+#pragma region C++ Includes
+#include <iostream>
+#pragma endregion
+
+#pragma region SDL Includes
+#include "SDL_ttf.h"
+#pragma endregion
+
+#pragma region Engine Includes
+#include "Colors.h"
+#pragma endregion
+
+map<pair<string, int>, GlyphAtlas *> GlyphAtlas::atlases;
+Uint64 GlyphAtlas::bakeCount = 0;
+
+GlyphAtlas::GlyphAtlas(const string & fontPath, int fontSize)
+{
+	for(Glyph & glyph : glyphs)
+		glyph = Glyph{SDL_Rect{0, 0, 0, 0}, 0};
+
+	//	Opening the font reads and parses its file, that's left to the asset manager's workers
+	font = AssetManager::Get().LoadFont(fontPath, fontSize);
+}
+
+GlyphAtlas::~GlyphAtlas()
+{
+	AssetManager::Get().Release(font);
+	font = nullptr;
+	if(texture)
+	{
+		SDL_DestroyTexture(texture);
+		texture = nullptr;
+	}
+}
+
+GlyphAtlas * GlyphAtlas::Get(SDL_Renderer * r, const string & fontPath, int fontSize)
+{
+	//	Created on first use, failures are remembered too, so a missing font isn't loaded again each time
+	const pair<string, int> key(fontPath, fontSize);
+	auto cached = atlases.find(key);
+	if(cached == atlases.end())
+		cached = atlases.insert(make_pair(key, new GlyphAtlas(fontPath, fontSize))).first;
+	GlyphAtlas * atlas = cached->second;
+
+	//	Bake as soon as the font is loaded, the font isn't needed afterwards (the asset manager reports loading errors)
+	if(atlas->font && !atlas->font->IsLoading())
+	{
+		if(atlas->font->IsReady())
+			atlas->Bake(r, atlas->font->GetFont());
+		AssetManager::Get().Release(atlas->font);
+		atlas->font = nullptr;
+	}
+
+	return atlas;
+}
+
+void GlyphAtlas::ReleaseAll()
+{
+	for(auto & atlas : atlases)
+		delete atlas.second;
+	atlases.clear();
+}
+
+void GlyphAtlas::Bake(SDL_Renderer * r, TTF_Font * ttfFont)
+{
+	lineHeight = TTF_FontHeight(ttfFont);
+
+	/*
+	 * First pass: rasterize each glyph on its own surface
+	 * and find a place for it in the atlas, filling rows
+	 * from left to right (glyphs of a font have similar
+	 * heights, so this simple packing wastes little space).
+	 */
+	SDL_Surface * glyphSurfaces[GLYPH_ATLAS_CHAR_COUNT];
+	int penX = GLYPH_ATLAS_SPACING;
+	int penY = GLYPH_ATLAS_SPACING;
+	int rowHeight = 0;
+	for(int c = GLYPH_ATLAS_FIRST_CHAR; c <= GLYPH_ATLAS_LAST_CHAR; c++)
+	{
+		Glyph & glyph = glyphs[c - GLYPH_ATLAS_FIRST_CHAR];
+		SDL_Surface * & surface = glyphSurfaces[c - GLYPH_ATLAS_FIRST_CHAR];
+
+		int minX, maxX, minY, maxY;
+		if(TTF_GlyphMetrics32(ttfFont, (Uint32)c, &minX, &maxX, &minY, &maxY, &glyph.advance) != 0)
+			glyph.advance = 0;
+
+		surface = TTF_RenderGlyph32_Blended(ttfFont, (Uint32)c, SDLC_WHITE);
+		if(!surface || surface->w <= 0 || surface->h <= 0)
+			continue;
+
+		if(penX + surface->w + GLYPH_ATLAS_SPACING > GLYPH_ATLAS_WIDTH)
+		{
+			penX = GLYPH_ATLAS_SPACING;
+			penY += rowHeight + GLYPH_ATLAS_SPACING;
+			rowHeight = 0;
+		}
+		glyph.source = SDL_Rect{penX, penY, surface->w, surface->h};
+		penX += surface->w + GLYPH_ATLAS_SPACING;
+		if(surface->h > rowHeight)
+			rowHeight = surface->h;
+	}
+
+	//	Second pass: copy all the glyphs into a single surface, then upload it
+	textureSize = Vector2(GLYPH_ATLAS_WIDTH, penY + rowHeight + GLYPH_ATLAS_SPACING);
+	SDL_Surface * atlasSurface = SDL_CreateRGBSurfaceWithFormat(0, textureSize.x, textureSize.y, 32, SDL_PIXELFORMAT_RGBA32);
+	if(atlasSurface)
+	{
+		SDL_FillRect(atlasSurface, nullptr, SDL_MapRGBA(atlasSurface->format, 255, 255, 255, 0));
+		for(int c = 0; c < GLYPH_ATLAS_CHAR_COUNT; c++)
+		{
+			if(!glyphSurfaces[c] || glyphs[c].source.w <= 0)
+				continue;
+
+			//	Copy pixels as they are, alpha included
+			SDL_SetSurfaceBlendMode(glyphSurfaces[c], SDL_BLENDMODE_NONE);
+			SDL_BlitSurface(glyphSurfaces[c], nullptr, atlasSurface, &glyphs[c].source);
+		}
+
+		texture = SDL_CreateTextureFromSurface(r, atlasSurface);
+		if(texture)
+		{
+			SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
+			bakeCount++;
+		}
+		else
+			cout << "Couldn't create glyph atlas texture for \"" << font->GetPath() << "\": " << SDL_GetError() << endl;
+		SDL_FreeSurface(atlasSurface);
+	}
+	else
+		cout << "Couldn't create glyph atlas surface for \"" << font->GetPath() << "\": " << SDL_GetError() << endl;
+
+	for(SDL_Surface * surface : glyphSurfaces)
+		if(surface)
+			SDL_FreeSurface(surface);
+}
+
+Vector2 GlyphAtlas::Measure(const string & text) const
+{
+	int width = 0;
+	for(const char & c : text)
+		width += GetGlyph(c).advance;
+
+	return Vector2(width, lineHeight);
+}
+
+void GlyphAtlas::BuildQuads(const string & text, float x, float y, float scale, const SDL_Color & color, vector<SDL_Vertex> & vertices, vector<int> & indices) const
+{
+	vertices.clear();
+	indices.clear();
+
+	const float u = 1.0f / textureSize.x;
+	const float v = 1.0f / textureSize.y;
+	float penX = x;
+	for(const char & c : text)
+	{
+		const Glyph & glyph = GetGlyph(c);
+
+		//	Glyphs with no pixels only move the pen
+		if(glyph.source.w > 0)
+		{
+			const float left = penX;
+			const float top = y;
+			const float right = penX + glyph.source.w * scale;
+			const float bottom = y + glyph.source.h * scale;
+			const float sourceLeft = glyph.source.x * u;
+			const float sourceTop = glyph.source.y * v;
+			const float sourceRight = (glyph.source.x + glyph.source.w) * u;
+			const float sourceBottom = (glyph.source.y + glyph.source.h) * v;
+
+			//	Quad corners clockwise from top-left, then two triangles
+			const int first = (int)vertices.size();
+			vertices.push_back(SDL_Vertex{SDL_FPoint{left, top}, color, SDL_FPoint{sourceLeft, sourceTop}});
+			vertices.push_back(SDL_Vertex{SDL_FPoint{right, top}, color, SDL_FPoint{sourceRight, sourceTop}});
+			vertices.push_back(SDL_Vertex{SDL_FPoint{right, bottom}, color, SDL_FPoint{sourceRight, sourceBottom}});
+			vertices.push_back(SDL_Vertex{SDL_FPoint{left, bottom}, color, SDL_FPoint{sourceLeft, sourceBottom}});
+			indices.push_back(first);
+			indices.push_back(first + 1);
+			indices.push_back(first + 2);
+			indices.push_back(first);
+			indices.push_back(first + 2);
+			indices.push_back(first + 3);
+		}
+
+		penX += glyph.advance * scale;
+	}
+}
+
+void GlyphAtlas::Draw(SDL_Renderer * r, const vector<SDL_Vertex> & vertices, const vector<int> & indices) const
+{
+	if(indices.empty())
+		return;
+
+	SDL_RenderGeometry(r, texture, vertices.data(), (int)vertices.size(), indices.data(), (int)indices.size());
+}
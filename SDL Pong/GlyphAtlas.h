@@ -0,0 +1,112 @@
+#pragma once
+
+#pragma region C++ Includes
+#include <string>
+#include <vector>
+#include <map>
+#pragma endregion
+
+#pragma region SDL Includes
+#include "SDL.h"
+#pragma endregion
+
+#pragma region Engine Includes
+#include "Types.h"
+#include "AssetManager.h"
+#pragma endregion
+
+using namespace std;
+
+//	Characters baked into each atlas (printable ASCII), anything else is drawn as GLYPH_ATLAS_FALLBACK_CHAR
+#define GLYPH_ATLAS_FIRST_CHAR 32
+#define GLYPH_ATLAS_LAST_CHAR 126
+#define GLYPH_ATLAS_CHAR_COUNT (GLYPH_ATLAS_LAST_CHAR - GLYPH_ATLAS_FIRST_CHAR + 1)
+#define GLYPH_ATLAS_FALLBACK_CHAR '?'
+//	Width of the atlas texture, glyphs are packed in rows
+#define GLYPH_ATLAS_WIDTH 1024
+#define GLYPH_ATLAS_SPACING 1
+
+/*
+ * All the glyphs of a font, at a given size,
+ * rasterized once into a single texture.
+ * Text is then drawn as a list of quads (two
+ * triangles per character) mapping portions of
+ * the atlas, all submitted with a single call to
+ * SDL_RenderGeometry().
+ * Changing a text only means rebuilding its quads,
+ * which takes time proportional to its length and
+ * no allocations (vertex buffers are reused), while
+ * rendering a string with TTF means rasterizing all
+ * the glyphs and creating a new texture each time.
+ * Glyphs are baked in white, the color of the text
+ * comes from the vertices.
+ *
+ * Atlases are shared: there's one for each font
+ * and size, created on first use (see Get()). The
+ * font is loaded in the background by the asset
+ * manager and the atlas is baked on the first Get()
+ * after it's ready, until then there's nothing to
+ * draw with.
+ */
+class GlyphAtlas
+{
+	// Fields
+public:
+protected:
+private:
+	typedef struct
+	{
+		SDL_Rect source;	//	Portion of the atlas, empty for glyphs with no pixels (e.g. space)
+		int advance;	//	Horizontal distance to the next glyph
+	} Glyph;
+
+	Asset * font = nullptr;	//	Held until the atlas is baked (or the font fails to load)
+	SDL_Texture * texture = nullptr;
+	Vector2 textureSize{0, 0};
+	int lineHeight = 0;
+	Glyph glyphs[GLYPH_ATLAS_CHAR_COUNT];
+
+	static map<pair<string, int>, GlyphAtlas *> atlases;
+	static Uint64 bakeCount;	//	Atlases baked so far, each one is a texture upload
+	// Constructors
+public:
+	// Delete copy constructor and assignment operator (atlases own their texture)
+	GlyphAtlas(const GlyphAtlas &) = delete;
+	GlyphAtlas & operator=(const GlyphAtlas &) = delete;
+	~GlyphAtlas();
+protected:
+private:
+	GlyphAtlas(const string & fontPath, int fontSize);
+	// Methods
+public:
+	//	Returns the shared atlas of a font at a size, requesting the font on first use and baking the atlas once it's loaded
+	static GlyphAtlas * Get(SDL_Renderer * r, const string & fontPath, int fontSize);
+	//	Destroys all atlases, call before destroying the renderer
+	static void ReleaseAll();
+	__inline static Uint64 GetBakeCount() { return bakeCount; }
+
+	//	True while the font is loading, the atlas can't be used yet
+	__inline bool IsLoading() const { return font != nullptr; }
+	//	True once baked, false while loading and forever if the font couldn't be loaded
+	__inline bool IsReady() const { return texture != nullptr; }
+	__inline int GetLineHeight() const { return lineHeight; }
+	//	Size of a text rendered with this atlas, at scale 1
+	Vector2 Measure(const string & text) const;
+	/*
+	 * Fills vertices and indices with the quads of text,
+	 * placed with its top-left corner at (x, y) and scaled.
+	 * Buffers are cleared first, their capacity is reused.
+	 */
+	void BuildQuads(const string & text, float x, float y, float scale, const SDL_Color & color, vector<SDL_Vertex> & vertices, vector<int> & indices) const;
+	//	Draws quads built with BuildQuads()
+	void Draw(SDL_Renderer * r, const vector<SDL_Vertex> & vertices, const vector<int> & indices) const;
+protected:
+private:
+	//	Rasterizes the glyphs of the font and uploads them
+	void Bake(SDL_Renderer * r, struct _TTF_Font * ttfFont);
+	__inline const Glyph & GetGlyph(char c) const
+	{
+		const int index = (c >= GLYPH_ATLAS_FIRST_CHAR && c <= GLYPH_ATLAS_LAST_CHAR) ? c : GLYPH_ATLAS_FALLBACK_CHAR;
+		return glyphs[index - GLYPH_ATLAS_FIRST_CHAR];
+	}
+};
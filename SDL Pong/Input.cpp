@@ -1,18 +1,107 @@
 #include "Input.h"
 
-void Input::NotifyKeyDown(const SDL_Keycode & key)
+#pragma region C++ Includes
+#include <cstring>
+#include <cmath>
+#pragma endregion
+
+void Input::NotifyKeyDown(SDL_Scancode key, Uint32 timestamp)
+{
+	if(key <= SDL_SCANCODE_UNKNOWN || key >= SDL_NUM_SCANCODES)
+		return;
+
+	//	Key repeats aren't changes
+	if(Test(held, key))
+		return;
+	Set(held, key);
+	Set(pressed, key);
+	Record(key, timestamp, true);
+}
+
+void Input::NotifyKeyUp(SDL_Scancode key, Uint32 timestamp)
+{
+	if(key <= SDL_SCANCODE_UNKNOWN || key >= SDL_NUM_SCANCODES)
+		return;
+
+	if(!Test(held, key))
+		return;
+	Reset(held, key);
+	Set(released, key);
+	Record(key, timestamp, false);
+}
+
+void Input::BeginTick(Uint32 reference, double start, double end)
+{
+	tickTimed = end > start;
+	tickReference = reference;
+	tickStart = start;
+	tickEnd = end;
+}
+
+void Input::EndTick()
 {
-	buttonsMap[key] = true;
+	memset(pressed, 0, sizeof(pressed));
+	memset(released, 0, sizeof(released));
+
+	//	Events stamped after the tick belong to the next ones
+	if(tickTimed)
+		while(tickEventsBegin != eventsWritten && GetEventTime(GetTickEvent(0)) <= tickEnd)
+			tickEventsBegin++;
+	else
+		tickEventsBegin = eventsWritten;
+	tickTimed = false;
 }
 
-void Input::NotifyKeyUp(const SDL_Keycode & key)
+Fixed Input::GetKeyHeldFraction(SDL_Scancode key) const
 {
-	buttonsMap[key] = false;
+	if(!tickTimed)
+		return GetKey(key) ? FIXED_ONE : 0;
+
+	/*
+	 * Find whether the key was held when the tick began:
+	 * repeats aren't recorded, so the key was in the
+	 * opposite state of its first pending event (or in
+	 * its current state, if it has none).
+	 */
+	const int eventCount = GetTickEventCount();
+	bool down = GetKey(key);
+	for(int i = 0; i < eventCount; i++)
+		if(GetTickEvent(i).key == key)
+		{
+			down = !GetTickEvent(i).down;
+			break;
+		}
+
+	//	Sum the time held between the changes, those stamped before the tick count as its beginning
+	double heldTime = 0.0;
+	double from = tickStart;
+	for(int i = 0; i < eventCount; i++)
+	{
+		const InputEvent & event = GetTickEvent(i);
+		if(event.key != key)
+			continue;
+		double at = GetEventTime(event);
+		if(at > tickEnd)
+			break;
+		if(at < tickStart)
+			at = tickStart;
+		if(down)
+			heldTime += at - from;
+		down = event.down;
+		from = at;
+	}
+	if(down)
+		heldTime += tickEnd - from;
+
+	return (Fixed)lround(heldTime / (tickEnd - tickStart) * FIXED_ONE);
 }
 
-bool Input::GetKey(const SDL_Keycode & key) const
+void Input::Record(SDL_Scancode key, Uint32 timestamp, bool down)
 {
-	auto keyCheck = buttonsMap.find(key);
+	events[eventsWritten & (INPUT_EVENTS_CAPACITY - 1)] = InputEvent{timestamp, key, down};
+	eventsWritten++;
 
-	return keyCheck != buttonsMap.end() && keyCheck->second;
+	//	The buffer is full, the oldest event not consumed yet has just been overwritten
+	if(eventsWritten - tickEventsBegin > INPUT_EVENTS_CAPACITY)
+		tickEventsBegin = eventsWritten - INPUT_EVENTS_CAPACITY;
 }
@@ -1,22 +1,72 @@
 #pragma once
 
-#pragma region C++ Includes
-#include <map>
+#pragma region SDL Includes
+#include "SDL_stdinc.h"
+#include "SDL_scancode.h"
 #pragma endregion
 
-#pragma region SDL Includes
-#include "SDL_keycode.h"
+#pragma region Engine Includes
+#include "Fixed.h"
 #pragma endregion
 
 using namespace std;
 
+#pragma region Constant Parameters
+#define INPUT_KEY_WORDS ((SDL_NUM_SCANCODES + 31) / 32)	//	32 keys per word
+#define INPUT_EVENTS_CAPACITY 64	//	Power of 2, events kept in the ring buffer
+#pragma endregion
+
+//	A key going down or up, as reported by the system
+typedef struct
+{
+	Uint32 timestamp;	//	Milliseconds since SDL was initialized (see SDL_KeyboardEvent)
+	SDL_Scancode key;
+	bool down;
+} InputEvent;
+
+/*
+ * State of the keyboard as seen by the simulation.
+ * Keys are identified by scancode (the physical key,
+ * whatever the layout) and kept in flat bitsets: one
+ * for the keys held, one for those that went down and
+ * one for those that went up since the last tick, so
+ * checking a key is a shift and a mask.
+ * Edges survive until a tick consumes them (see
+ * EndTick()), so a key tapped between two ticks is
+ * still seen going down and up, even if it's no
+ * longer held by then.
+ * Each change is also recorded, with its timestamp, in
+ * a ring buffer, for logic that cares when exactly a
+ * key changed within a tick; when more changes than
+ * the buffer holds happen between two ticks, the
+ * oldest ones are lost.
+ * Ticks simulate time that already passed: when told
+ * which span of time a tick simulates (see BeginTick())
+ * the events are replayed over that span, to know for
+ * how long a key was held during it (see
+ * GetKeyHeldFraction()), and those stamped after it are
+ * left to the following ticks.
+ * Input is fed and read by the same thread (the one
+ * polling events and simulating).
+ */
 class Input
 {
 	// Fields
 public:
 protected:
 private:
-	map<SDL_Keycode, bool> buttonsMap;
+	Uint32 held[INPUT_KEY_WORDS] = { };
+	Uint32 pressed[INPUT_KEY_WORDS] = { };	//	Went down since the last tick
+	Uint32 released[INPUT_KEY_WORDS] = { };	//	Went up since the last tick
+
+	InputEvent events[INPUT_EVENTS_CAPACITY];
+	Uint32 eventsWritten = 0;	//	Events ever recorded, the next one goes at this index (masked)
+	Uint32 tickEventsBegin = 0;	//	First event not consumed by a tick yet
+
+	bool tickTimed = false;	//	True when the span of time simulated by the current tick is known
+	Uint32 tickReference = 0;	//	Time the span is relative to (see SDL_GetTicks())
+	double tickStart = 0.0;	//	Milliseconds after the reference
+	double tickEnd = 0.0;
 	// Constructors
 public:
 	// Delete copy constructor and assignment operator (singleton protection)
@@ -33,11 +83,32 @@ public:
 		static Input instance;
 		return instance;
 	}
-	void NotifyKeyDown(const SDL_Keycode & key);
-	void NotifyKeyUp(const SDL_Keycode & key);
+	void NotifyKeyDown(SDL_Scancode key, Uint32 timestamp = 0);
+	void NotifyKeyUp(SDL_Scancode key, Uint32 timestamp = 0);
+	//	The tick about to run simulates the given span of time, from start to end milliseconds after reference (a SDL_GetTicks() time)
+	void BeginTick(Uint32 reference, double start, double end);
+	//	Consumes the edges and the events up to the end of the tick, call after each tick
+	void EndTick();
+
+	//	True while the key is held
+	__inline bool GetKey(SDL_Scancode key) const { return Test(held, key); }
+	//	True if the key went down since the last tick
+	__inline bool GetKeyDown(SDL_Scancode key) const { return Test(pressed, key); }
+	//	True if the key went up since the last tick
+	__inline bool GetKeyUp(SDL_Scancode key) const { return Test(released, key); }
+	//	From 0 to 1 (in fixed point), how much of the current tick the key was held for (when the tick span isn't known, 1 if held)
+	Fixed GetKeyHeldFraction(SDL_Scancode key) const;
 
-	bool GetKey(const SDL_Keycode & key) const;
+	//	Events not consumed by a tick yet, oldest first
+	__inline int GetTickEventCount() const { return (int)(eventsWritten - tickEventsBegin); }
+	__inline const InputEvent & GetTickEvent(int index) const { return events[(tickEventsBegin + index) & (INPUT_EVENTS_CAPACITY - 1)]; }
 protected:
 private:
+	void Record(SDL_Scancode key, Uint32 timestamp, bool down);
+	//	Milliseconds from the tick reference to the event (the difference survives the wrap around of timestamps)
+	__inline double GetEventTime(const InputEvent & event) const { return (double)(Sint32)(event.timestamp - tickReference); }
+	__inline static bool Test(const Uint32 * bits, SDL_Scancode key) { return (bits[key >> 5] >> (key & 31)) & 1; }
+	__inline static void Set(Uint32 * bits, SDL_Scancode key) { bits[key >> 5] |= 1u << (key & 31); }
+	__inline static void Reset(Uint32 * bits, SDL_Scancode key) { bits[key >> 5] &= ~(1u << (key & 31)); }
 };
 
@@ -6,27 +6,25 @@
 #endif
 #pragma endregion
 
-#pragma region SDL Includes
-#include "SDL_ttf.h"
-#pragma endregion
-
 #pragma region Engine Includes
 #include "PathUtils.h"
+#include "RenderBatcher.h"
+#include "DirtyRects.h"
 #pragma endregion
 
+Uint64 Label::textRebuilds = 0;
 
 Label::Label(string initialText, Uint8 initialFontSize) :
 	color{255, 255, 255, 255},
 	fontSize(initialFontSize)
 {
 	SetFontPath("8bit16");
-	SetText(initialText);	//	Triggers a render of the font texture
+	SetText(initialText);	//	Triggers a build of the text quads
 }
 
 Label::~Label()
 {
-	//	Remember to free texture to avoid memory leaks
-	ClearTexture();
+	//	Nothing to free, the atlas is shared and outlives labels
 }
 
 const SDL_Rect Label::GetRect() const
@@ -48,7 +46,7 @@ void Label::SetColor(Uint8 r, Uint8 g, Uint8 b, Uint8 a)
 	color.b = b;
 	color.a = a;
 
-	SetDirty();	//	Schedules a render of the font texture
+	SetDirty();	//	Schedules a build of the text quads
 }
 
 void Label::PreRender(SDL_Renderer * r)
@@ -60,39 +58,48 @@ void Label::PreRender(SDL_Renderer * r)
 	 * that modify the state of this class (which are
 	 * typically called during the update stage) set
 	 * a dirty flag.
-	 * To render and cache the texture upon changes, we
-	 * need a reference to a renderer, which we do not have
+	 * To build and cache the quads upon changes, we need
+	 * a reference to a renderer (the glyph atlas is a
+	 * texture, baked on first use), which we do not have
 	 * during the update stage. We would have it during the
 	 * render stage, but, by design, render must not change
 	 * anything (it's a const function) so the pre-render
 	 * stage is the best place where we have a renderer and
 	 * we can actually make changes.
-	 * See RenderCurrentText() for more details.
+	 * See BuildCurrentText() for more details.
 	 */
 
-	//	if any change has been made, render the texture
-	if(IsDirty())
+	//	if any change has been made (moving the label too), build the quads
+	const SDL_Rect currentRect = GetRect();
+	if(IsDirty() || (atlas && !SDL_RectEquals(&quadsRect, &currentRect)))
 	{
-		RenderCurrentText(r);
+		//	Both the old text and the new one need to be drawn again (cleaned first, building may need another try)
 		CleanDirty();
+		DirtyRects::Get().Invalidate(quadsRect);
+		BuildCurrentText(r);
+		DirtyRects::Get().Invalidate(quadsRect);
 	}
 }
 
 void Label::Render(SDL_Renderer * r) const
 {
 	/*
-	 * This function limits its execution to making
-	 * a copy of the pre-rendered font texture to
-	 * the assigned render target.
-	 * The actual render occurs only when any of the
+	 * This function limits its execution to drawing
+	 * the pre-built quads, with a single geometry call
+	 * mapping glyphs from the shared atlas texture.
+	 * Quads are built anew only when any of the
 	 * parameters affecting the render result changes.
-	 * If a render was not done yet (shouldn't happen)
-	 * the function does nothing but, in debug mode,
-	 * draws a magenta marker indicating an error
-	 * in text rendering.
+	 * If the atlas isn't available (missing font, or
+	 * font still loading) the function does nothing
+	 * but, in debug mode, draws a magenta marker
+	 * where the text should be.
+	 * Rects still queued in the render batcher are
+	 * drawn first, as they're meant to be behind.
 	 */
 
-	if(!fontTexture)
+	RenderBatcher::Get().Flush(r);
+
+	if(!atlas)
 	{
 #ifdef _DEBUG
 		SDL_SetRenderDrawColor(r, 255, 0, 255, 255);
@@ -102,97 +109,77 @@ void Label::Render(SDL_Renderer * r) const
 		return;
 	}
 
-	//	Copy the cached texture into the right portion of the render target
-	SDL_Rect currentRect = GetRect();
-	SDL_RenderCopy(r, fontTexture, nullptr, &currentRect);
+	atlas->Draw(r, vertices, indices);
 }
 
 void Label::SetText(const string & newText)
 {
+	//	Same text, same quads: no need to build them again
+	if(newText == text)
+		return;
+
 	text = newText;
-	SetDirty();	//	Schedules a render of the font texture
+	SetDirty();	//	Schedules a build of the text quads
 }
 
 void Label::SetFontPath(const string & newFontPath)
 {
 	fontPath = PathUtils::Combine(
 		{
-			SDL_GetBasePath(),
+			PathUtils::GetBasePath(),
 			"res",
 			"fonts",
 			PathUtils::AddFontExtension(newFontPath)
 		}
 	);
-	SetDirty();	//	Schedules a render of the font texture
+	SetDirty();	//	Schedules a build of the text quads
 }
 
 void Label::SetFontSize(Uint8 newFontSize)
 {
 	fontSize = newFontSize;
-	SetDirty();	//	Schedules a render of the font texture
-}
-
-void Label::ClearTexture()
-{
-	if(!fontTexture)
-		return;
-
-	SDL_DestroyTexture(fontTexture);
-	fontTexture = nullptr;
+	SetDirty();	//	Schedules a build of the text quads
 }
 
-void Label::RenderCurrentText(SDL_Renderer * r)
+void Label::BuildCurrentText(SDL_Renderer * r)
 {
 	/*
-	 * This function actually renders the current state of the
-	 * Label class to a texture. Doing this operation each frame
-	 * isn't necessary as most of time the text doesn't change.
-	 * For this reason, we decided to call this function only
-	 * when strictly needed (aka, when the state of the class
-	 * changes).
+	 * This function builds the quads drawing the current
+	 * state of the Label class: one quad per glyph, all
+	 * mapping the same atlas texture. Doing this operation
+	 * each frame isn't necessary as most of time the text
+	 * doesn't change. For this reason, we decided to call
+	 * this function only when strictly needed (aka, when
+	 * the state of the class changes).
+	 * Unlike rendering the text with TTF, no texture is
+	 * created here: the atlas of a font and size is baked
+	 * once and shared by all labels using them.
 	 * See PreRender() for further details.
 	 */
-	//	Build the absolute path of the font to load
-	string fullPath = GetFontPath();
-
-	//	Load the font object
-	TTF_Font * font = TTF_OpenFont(fullPath.c_str(), (int)GetFontSize());
+	GlyphAtlas * sharedAtlas = GlyphAtlas::Get(r, GetFontPath(), (int)GetFontSize());
+	atlas = sharedAtlas->IsReady() ? sharedAtlas : nullptr;
 
-	//	Handle font loading errors
-	if(!font)
+	//	Handle fonts still loading (nothing is shown until they're ready) and font loading errors
+	if(!atlas)
 	{
-#ifdef _DEBUG
 		size.x = GetFontSize();
 		size.y = GetFontSize();
-		cout << "--> Couldn't load font \"" << fullPath << "\" with size " << (int)GetFontSize() << endl;
-		cout << "--> TTF Error: " << TTF_GetError() << endl;
-#endif
-		return;
-	}
-
-	//	Render the text to a surface and store the final size
-	SDL_Surface * surf = TTF_RenderText_Blended(font, GetText().c_str(), GetColor());	//	Using the *_Blended version to allow transparent background
-	size.x = surf->w;
-	size.y = surf->h;
-
-	//	Crete a texture from the surface (free previous cached texture, if any)
-	ClearTexture();
-	fontTexture = SDL_CreateTextureFromSurface(r, surf);
-
-	//	Handle font rendering errors
-	if(!font)
-	{
+		vertices.clear();
+		indices.clear();
+		if(sharedAtlas->IsLoading())
+		{
+			SetDirty();	//	Try again on the next pre-render
+			return;
+		}
 #ifdef _DEBUG
-		size.x = GetFontSize();
-		size.y = GetFontSize();
-		cout << "--> Font loaded but couldn't render it to texture." << endl;
-		cout << "--> Font Rendering Error: " << SDL_GetError() << endl;
+		cout << "--> Couldn't get glyph atlas of \"" << GetFontPath() << "\" with size " << (int)GetFontSize() << endl;
 #endif
 		return;
 	}
 
-	//	Free up surface memory
-	SDL_FreeSurface(surf);
-	//	Free up font memory
-	TTF_CloseFont(font);
+	//	Measure first, the placement of the quads depends on the size and pivot
+	size = atlas->Measure(GetText());
+	quadsRect = GetRect();
+	atlas->BuildQuads(GetText(), (float)quadsRect.x, (float)quadsRect.y, t.scale, GetColor(), vertices, indices);
+	textRebuilds++;
 }
@@ -5,6 +5,8 @@
 
 #include "SDL.h"
 
+#include "GlyphAtlas.h"
+
 /*
  * Class that allows to display text in
  * a 2D space.
@@ -14,12 +16,16 @@ class Label : public ITransformable, public ITextRenderable
 private:
 	Transform t;	//	Gives a label a place in 2D space
 	string text;	//	The text displayed by the label
-	SDL_Texture * fontTexture;	//	The cached texture of the rendered text
+	GlyphAtlas * atlas = nullptr;	//	The shared atlas of the font, at the label's font size
+	vector<SDL_Vertex> vertices;	//	The cached quads of the text, one per glyph
+	vector<int> indices;
+	SDL_Rect quadsRect{0, 0, 0, 0};	//	Where the cached quads were placed, they're built anew when the label moves
 	SDL_Color color;	//	The color for the rendered text
 	string fontPath = "";	//	The path to the font (relative to the base directory /res/fonts/ directory, with no extension, that will be added based on platform)
 	Uint8 fontSize = 24;	//	The point size of the rendered font
-	Vector2 size{0, 0};	//	The 2D size of the rendered font texture
-	bool isDirty = false;	//	Set to true each time a change is made, when true, texture will be rendered anew
+	Vector2 size{0, 0};	//	The 2D size of the text, at scale 1
+	bool isDirty = false;	//	Set to true each time a change is made, when true, quads will be built anew
+	static Uint64 textRebuilds;	//	How many times any label built its quads, useful to spot labels changing too often
 
 public:
 	//	Constructor and destructor
@@ -46,12 +52,13 @@ public:
 	virtual const Uint8 & GetFontSize() const override { return fontSize; }
 	void SetFontSize(Uint8 newFontSize);
 
+	__inline static Uint64 GetTextRebuilds() { return textRebuilds; }
+
 private:
 	__inline void SetDirty() { isDirty = true; }
 	__inline void CleanDirty() { isDirty = false; }
 	__inline bool IsDirty() const { return isDirty; }
-	void ClearTexture();
-	//	Creates the font texture based on the current object's state
-	void RenderCurrentText(SDL_Renderer * r);
+	//	Builds the quads of the text based on the current object's state
+	void BuildCurrentText(SDL_Renderer * r);
 };
 
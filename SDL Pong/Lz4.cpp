@@ -0,0 +1,197 @@
+#include "Lz4.h"
+
+#pragma region C++ Includes
+#include <cstring>
+#include <vector>
+#pragma endregion
+
+using namespace std;
+
+#pragma region Constant Parameters
+#define LZ4_MIN_MATCH 4
+#define LZ4_MAX_OFFSET 65535
+//	Format rules: the last 5 bytes are always literals, the last match starts at least 12 bytes before the end
+#define LZ4_LAST_LITERALS 5
+#define LZ4_MATCH_SAFE_DISTANCE 12
+#define LZ4_HASH_BITS 16
+#pragma endregion
+
+static uint32_t Read32(const uint8_t * p)
+{
+	uint32_t value;
+	memcpy(&value, p, sizeof(value));
+	return value;
+}
+
+static uint32_t Hash(uint32_t sequence)
+{
+	//	Multiplicative hash of 4 bytes, the top bits are the most mixed
+	return (sequence * 2654435761u) >> (32 - LZ4_HASH_BITS);
+}
+
+static bool WriteLength(size_t length, uint8_t * & out, const uint8_t * outEnd)
+{
+	//	Lengths past the 4 bits of the token continue in bytes of 255, closed by a smaller one
+	while(length >= 255)
+	{
+		if(out >= outEnd)
+			return false;
+		*out++ = 255;
+		length -= 255;
+	}
+	if(out >= outEnd)
+		return false;
+	*out++ = (uint8_t)length;
+	return true;
+}
+
+static bool WriteSequence(const uint8_t * literals, size_t literalLength, size_t offset, size_t matchLength, uint8_t * & out, const uint8_t * outEnd)
+{
+	//	Token: literal length in the high nibble, match length (minus the minimum) in the low one
+	if(out >= outEnd)
+		return false;
+	uint8_t * token = out++;
+	*token = (uint8_t)((literalLength < 15 ? literalLength : 15) << 4);
+	if(literalLength >= 15 && !WriteLength(literalLength - 15, out, outEnd))
+		return false;
+
+	if((size_t)(outEnd - out) < literalLength)
+		return false;
+	memcpy(out, literals, literalLength);
+	out += literalLength;
+
+	//	The last sequence has literals only
+	if(matchLength == 0)
+		return true;
+
+	if(outEnd - out < 2)
+		return false;
+	*out++ = (uint8_t)(offset & 0xFF);
+	*out++ = (uint8_t)(offset >> 8);
+	const size_t extraLength = matchLength - LZ4_MIN_MATCH;
+	*token |= (uint8_t)(extraLength < 15 ? extraLength : 15);
+	if(extraLength >= 15 && !WriteLength(extraLength - 15, out, outEnd))
+		return false;
+
+	return true;
+}
+
+size_t Lz4::GetMaxCompressedSize(size_t sourceSize)
+{
+	return sourceSize + sourceSize / 255 + 16;
+}
+
+size_t Lz4::Compress(const uint8_t * source, size_t sourceSize, uint8_t * destination, size_t destinationCapacity)
+{
+	/*
+	 * Greedy compression: at each position, the last place
+	 * the same 4 bytes were seen (from a hash table) is a
+	 * candidate match, extended as far as it goes. Not the
+	 * best ratio possible, but simple and quick, and the
+	 * decoder doesn't care how matches were found.
+	 */
+	uint8_t * out = destination;
+	const uint8_t * outEnd = destination + destinationCapacity;
+	const uint8_t * literals = source;
+
+	if(sourceSize > LZ4_MATCH_SAFE_DISTANCE)
+	{
+		vector<uint32_t> table((size_t)1 << LZ4_HASH_BITS, 0);
+		const uint8_t * matchLimit = source + sourceSize - LZ4_MATCH_SAFE_DISTANCE;
+		const uint8_t * end = source + sourceSize - LZ4_LAST_LITERALS;
+		const uint8_t * p = source;
+		while(p < matchLimit)
+		{
+			const uint32_t sequence = Read32(p);
+			uint32_t & slot = table[Hash(sequence)];
+			const uint8_t * candidate = source + slot;
+			slot = (uint32_t)(p - source);
+
+			if(candidate >= p || (size_t)(p - candidate) > LZ4_MAX_OFFSET || Read32(candidate) != sequence)
+			{
+				p++;
+				continue;
+			}
+
+			size_t matchLength = LZ4_MIN_MATCH;
+			while(p + matchLength < end && candidate[matchLength] == p[matchLength])
+				matchLength++;
+
+			if(!WriteSequence(literals, (size_t)(p - literals), (size_t)(p - candidate), matchLength, out, outEnd))
+				return 0;
+			p += matchLength;
+			literals = p;
+		}
+	}
+
+	//	Whatever is left goes out as literals
+	if(!WriteSequence(literals, (size_t)(source + sourceSize - literals), 0, 0, out, outEnd))
+		return 0;
+
+	return (size_t)(out - destination);
+}
+
+bool Lz4::Decompress(const uint8_t * source, size_t sourceSize, uint8_t * destination, size_t destinationSize)
+{
+	const uint8_t * in = source;
+	const uint8_t * inEnd = source + sourceSize;
+	uint8_t * out = destination;
+	uint8_t * outEnd = destination + destinationSize;
+
+	//	Reads the bytes extending a length, in and out of bounds checks included
+	auto readLength = [&](size_t & length) -> bool
+	{
+		uint8_t byte;
+		do
+		{
+			if(in >= inEnd)
+				return false;
+			byte = *in++;
+			length += byte;
+		} while(byte == 255);
+		return true;
+	};
+
+	while(in < inEnd)
+	{
+		const uint8_t token = *in++;
+
+		//	Literals
+		size_t literalLength = token >> 4;
+		if(literalLength == 15 && !readLength(literalLength))
+			return false;
+		if((size_t)(inEnd - in) < literalLength || (size_t)(outEnd - out) < literalLength)
+			return false;
+		memcpy(out, in, literalLength);
+		in += literalLength;
+		out += literalLength;
+
+		//	The last sequence ends after its literals
+		if(in >= inEnd)
+			break;
+
+		//	Match, copied byte by byte when it overlaps what it's writing (short offsets repeat patterns)
+		if(inEnd - in < 2)
+			return false;
+		const size_t offset = (size_t)in[0] | ((size_t)in[1] << 8);
+		in += 2;
+		size_t matchLength = (token & 0x0F);
+		if(matchLength == 15 && !readLength(matchLength))
+			return false;
+		matchLength += LZ4_MIN_MATCH;
+		if(offset == 0 || (size_t)(out - destination) < offset || (size_t)(outEnd - out) < matchLength)
+			return false;
+
+		const uint8_t * match = out - offset;
+		if(offset >= matchLength)
+		{
+			memcpy(out, match, matchLength);
+			out += matchLength;
+		}
+		else
+			for(size_t i = 0; i < matchLength; i++)
+				*out++ = *match++;
+	}
+
+	return out == outEnd;
+}
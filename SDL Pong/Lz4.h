@@ -0,0 +1,28 @@
+#pragma once
+
+#pragma region C++ Includes
+#include <cstddef>
+#include <cstdint>
+#pragma endregion
+
+/*
+ * Compression in the LZ4 block format: a sequence of
+ * literal runs, each followed by a copy of earlier
+ * bytes (offset and length). There's no entropy
+ * coding, so decompressing is little more than a
+ * memcpy, fast enough to be done at load time.
+ * Compressed blocks carry no header: the caller must
+ * know the size of the original data.
+ * Only standard types are used, so offline tools can
+ * compile this file too.
+ */
+class Lz4
+{
+public:
+	//	Worst case size of compressed data (incompressible input grows slightly)
+	static size_t GetMaxCompressedSize(size_t sourceSize);
+	//	Compresses source into destination, returns the compressed size (0 if destination is too small)
+	static size_t Compress(const uint8_t * source, size_t sourceSize, uint8_t * destination, size_t destinationCapacity);
+	//	Decompresses exactly destinationSize bytes, returns false on malformed or truncated data
+	static bool Decompress(const uint8_t * source, size_t sourceSize, uint8_t * destination, size_t destinationSize);
+};
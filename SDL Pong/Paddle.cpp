@@ -1,29 +1,35 @@
 #include "Paddle.h"
 
-#pragma region Engine includes
-#include "Input.h"
-#pragma endregion
-
 void Paddle::Update()
 {
-	int currentSpeed = 0;
-	if(Input::Get().GetKey(upKey))
-		currentSpeed = -speed;
-	else if(Input::Get().GetKey(downKey))
-		currentSpeed = speed;
-	//Move up/down (or still if no direction imparted)
-	Move(Vector2{0, currentSpeed});
+	/*
+	 * Move for as much of the tick as the keys were held,
+	 * from the moment they were pressed or released: the
+	 * response to a key doesn't depend on when the tick
+	 * happens to run after it.
+	 */
+	SetVelocity(FixedVector2(0, FixedMul(downTime - upTime, GetSpeed())));
+
+	//	Move up/down, skipping the move (and the limits check after it) when there's nothing to move
+	if(downTime - upTime != 0)
+		Move(GetVelocity());
 }
 
 void Paddle::PostMoveOperations()
 {
+	const FixedVector2 position = GetPosition();
+	const Fixed height = FixedFromInt(GetSize().y);
+	const FixedVector2 pivot = GetPivot();
+
 	//	Calculate offsets relative to pivot
-	int offsetUp = (int)(size.y * t.pivot.y);
-	int offsetDown = (int)(size.y * (1.0f - t.pivot.y));
+	const Fixed offsetUp = FixedMul(height, pivot.y);
+	const Fixed offsetDown = height - offsetUp;
 
 	//	Limit movement based on limits and pivot
-	if(t.position.y < upperLimit + offsetUp)
-		t.position.y = upperLimit + offsetUp;
-	else if(t.position.y > lowerLimit - offsetDown)
-		t.position.y = lowerLimit - offsetDown;
+	const Fixed minY = FixedFromInt(upperLimit) + offsetUp;
+	const Fixed maxY = FixedFromInt(lowerLimit) - offsetDown;
+	if(position.y < minY)
+		SetPosition(FixedVector2(position.x, minY));
+	else if(position.y > maxY)
+		SetPosition(FixedVector2(position.x, maxY));
 }
@@ -2,10 +2,6 @@
 
 #include "Body.h"
 
-#pragma region SDL Includes
-#include "SDL_keycode.h"
-#pragma endregion
-
 #pragma region Engine Includes
 #include "IUpdatable.h"
 #pragma endregion
@@ -19,13 +15,14 @@ class Paddle : public Body, public IUpdatable
 private:
 	int upperLimit = -9999;	//	Paddles have limited movement, this limits from above
 	int lowerLimit = 9999;	//	Paddles have limited movement, this limits from below
-	SDL_Keycode upKey = SDLK_UNKNOWN;
-	SDL_Keycode downKey = SDLK_UNKNOWN;
+	Fixed upTime = 0;	//	From 0 to 1, how much of the tick the up control was held for
+	Fixed downTime = 0;
 public:
 	using Body::Body;	//	This inherits base class' constructors
 	//	Used to update limits
 	__inline void SetLimits(int newUpperLimit, int newLowerLimit) { upperLimit = newUpperLimit; lowerLimit = newLowerLimit; }
-	__inline void SetControl(const SDL_Keycode & up, const SDL_Keycode & down) { upKey = up; downKey = down; }
+	//	Sets the controls for the next update, as fractions of the tick they were held for (the game reads them from the players or from a replay)
+	__inline void SetInput(Fixed upFraction, Fixed downFraction) { upTime = upFraction; downTime = downFraction; }
 	//	Perform frame operations
 	void Update() override;
 private:
@@ -5,6 +5,10 @@
 #include <algorithm>
 #pragma endregion
 
+#pragma region SDL Includes
+#include "SDL.h"
+#pragma endregion
+
 #pragma region Constant Parameters
 #define PATH_SEPARATOR_WINDOWS '\\'
 #define PATH_SEPARATOR_UNIX '/'
@@ -31,6 +35,30 @@
 #endif
 #pragma endregion
 
+const string & PathUtils::GetBasePath()
+{
+	/*
+	 * SDL_GetBasePath() queries the OS each time it's
+	 * called and returns a newly allocated string that
+	 * should be freed with SDL_free(). The base path
+	 * can't change while the application is running,
+	 * so we query it once and keep a copy around.
+	 */
+	static string basePath;
+	static bool basePathQueried = false;
+	if(!basePathQueried)
+	{
+		char * sdlBasePath = SDL_GetBasePath();
+		if(sdlBasePath)
+		{
+			basePath = sdlBasePath;
+			SDL_free(sdlBasePath);
+		}
+		basePathQueried = true;
+	}
+	return basePath;
+}
+
 void PathUtils::Conform(string & path)
 {
 	//	Replace all unsupported path separator characters with the supported ones
@@ -17,6 +17,7 @@ using namespace std;
 class PathUtils
 {
 public:
+	static const string & GetBasePath();
 	static void Conform(string & path);
 	static const string Combine(const vector<string> & parts);
 	static string AddImageExtension(const string &imageFileName);
@@ -0,0 +1,153 @@
+#include "PerfOverlay.h"
+
+#pragma region C++ Includes
+#include <cstdio>
+#pragma endregion
+
+#pragma region Platform Includes
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#include <psapi.h>
+#elif defined(__EMSCRIPTEN__)
+#include <emscripten/heap.h>
+#elif defined(__linux__)
+#include <unistd.h>
+#endif
+#pragma endregion
+
+#pragma region Engine Includes
+#include "Colors.h"
+#include "FrameProfiler.h"
+#include "RenderBatcher.h"
+#include "DirtyRects.h"
+#include "AssetManager.h"
+#pragma endregion
+
+#define PERF_OVERLAY_BACKGROUND SDL_Color{0, 0, 0, 160}
+
+PerfOverlay::PerfOverlay(int x, int y) :
+	rect{x, y, PERF_OVERLAY_WIDTH, PERF_OVERLAY_PADDING * 2 + PERF_OVERLAY_LINES * PERF_OVERLAY_LINE_HEIGHT},
+	color(PERF_OVERLAY_BACKGROUND),
+	lines
+	{
+		{"...", PERF_OVERLAY_FONT_SIZE},
+		{"...", PERF_OVERLAY_FONT_SIZE},
+		{"...", PERF_OVERLAY_FONT_SIZE},
+		{"...", PERF_OVERLAY_FONT_SIZE},
+		{"...", PERF_OVERLAY_FONT_SIZE},
+		{"...", PERF_OVERLAY_FONT_SIZE},
+		{"...", PERF_OVERLAY_FONT_SIZE}
+	}
+{
+	for(int line = 0; line < PERF_OVERLAY_LINES; line++)
+	{
+		lines[line].GetTransform()->pivot = Vector2F(0.0f, 0.0f);
+		lines[line].GetTransform()->position = Vector2(x + PERF_OVERLAY_PADDING, y + PERF_OVERLAY_PADDING + line * PERF_OVERLAY_LINE_HEIGHT);
+		lines[line].SetColor(SDLC_WHITE);
+	}
+}
+
+void PerfOverlay::SetVisible(bool newVisible)
+{
+	if(newVisible == visible)
+		return;
+
+	visible = newVisible;
+	DirtyRects::Get().Invalidate(rect);	//	Shows up on top of the game or leaves it uncovered
+
+	//	Refresh as soon as it shows up, with figures starting from now
+	lastRefresh = 0;
+	lastRefreshFrame = FrameProfiler::Get().GetFrameCount();
+}
+
+void PerfOverlay::PreRender(SDL_Renderer * r)
+{
+	if(!visible)
+		return;
+
+	//	Figures change a few times per second, not every frame
+	const Uint64 now = SDL_GetTicks64();
+	if(lastRefresh == 0 || now - lastRefresh >= PERF_OVERLAY_REFRESH_MS)
+	{
+		Refresh();
+		lastRefresh = now;
+	}
+
+	//	Only lines whose text changed build new quads
+	for(Label & line : lines)
+		line.PreRender(r);
+}
+
+void PerfOverlay::Render(SDL_Renderer * r) const
+{
+	if(!visible)
+		return;
+
+	//	Translucent panel, to keep the text readable on top of the game (lines flush it before drawing)
+	RenderBatcher::Get().FillRect(rect, color);
+
+	for(const Label & line : lines)
+		line.Render(r);
+}
+
+void PerfOverlay::Refresh()
+{
+	const FrameProfiler & profiler = FrameProfiler::Get();
+
+	//	Rates over the frames since the last refresh, percentiles over the same frames
+	const Uint64 frameCount = profiler.GetFrameCount();
+	int frames = (int)(frameCount - lastRefreshFrame);
+	if(frames <= 0 || frames > FRAME_PROFILER_CAPACITY)
+		frames = FRAME_PROFILER_CAPACITY;
+	lastRefreshFrame = frameCount;
+
+	double framesPerSecond, ticksPerSecond;
+	profiler.GetRates(frames, framesPerSecond, ticksPerSecond);
+
+	char text[64];
+	snprintf(text, sizeof(text), "Frame %.2fms p99 %.2fms", profiler.GetFramePercentile(50.0, frames), profiler.GetFramePercentile(99.0, frames));
+	lines[0].SetText(text);
+	snprintf(text, sizeof(text), "FPS %.0f  Sim %.0f ticks/s", framesPerSecond, ticksPerSecond);
+	lines[1].SetText(text);
+	snprintf(text, sizeof(text), "Present %.2fms p99 %.2fms", profiler.GetStagePercentile(PS_Present, 50.0, frames), profiler.GetStagePercentile(PS_Present, 99.0, frames));
+	lines[2].SetText(text);
+	snprintf(text, sizeof(text), "Text %llu rebuilds, %llu atlases", (unsigned long long)Label::GetTextRebuilds(), (unsigned long long)GlyphAtlas::GetBakeCount());
+	lines[3].SetText(text);
+	const RenderBatcher & batcher = RenderBatcher::Get();
+	snprintf(text, sizeof(text), "Rects %d in %d draw calls", batcher.GetRectCount(), batcher.GetDrawCalls());
+	lines[4].SetText(text);
+	const Uint64 memory = GetProcessMemory();
+	if(memory > 0)
+		snprintf(text, sizeof(text), "Memory %.1fMB", memory / (1024.0 * 1024.0));
+	else
+		snprintf(text, sizeof(text), "Memory n/a");
+	lines[5].SetText(text);
+	snprintf(text, sizeof(text), "Assets %d loading", AssetManager::Get().GetPendingCount());
+	lines[6].SetText(text);
+}
+
+Uint64 PerfOverlay::GetProcessMemory()
+{
+#if defined(_WIN32)
+	PROCESS_MEMORY_COUNTERS counters;
+	if(GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+		return counters.WorkingSetSize;
+	return 0;
+#elif defined(__EMSCRIPTEN__)
+	//	The wasm heap is all the memory the game can use
+	return emscripten_get_heap_size();
+#elif defined(__linux__)
+	//	Second field of statm is the resident set, in pages
+	FILE * statm = fopen("/proc/self/statm", "r");
+	if(!statm)
+		return 0;
+	unsigned long long totalPages = 0, residentPages = 0;
+	const int fields = fscanf(statm, "%llu %llu", &totalPages, &residentPages);
+	fclose(statm);
+	return fields == 2 ? residentPages * (Uint64)sysconf(_SC_PAGESIZE) : 0;
+#else
+	return 0;
+#endif
+}
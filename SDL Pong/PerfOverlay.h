@@ -0,0 +1,68 @@
+#pragma once
+
+#pragma region SDL Includes
+#include "SDL.h"
+#pragma endregion
+
+#pragma region Engine Includes
+#include "IRenderable.h"
+#include "Label.h"
+#pragma endregion
+
+//	Overlay layout and refresh rate
+#define PERF_OVERLAY_LINES 7
+#define PERF_OVERLAY_FONT_SIZE 16
+#define PERF_OVERLAY_LINE_HEIGHT 20
+#define PERF_OVERLAY_PADDING 8
+#define PERF_OVERLAY_WIDTH 300
+#define PERF_OVERLAY_REFRESH_MS 250
+
+/*
+ * A small panel showing how the game is performing:
+ * frame time, simulation ticks per second, present
+ * time, how many times labels have rebuilt their
+ * text (and glyph atlases baked), how many draw calls
+ * filled rects took, the memory used by the process
+ * and how many assets are still loading.
+ * Figures come from the frame profiler and are only
+ * refreshed a few times per second, which is enough
+ * to read them and keeps the overlay cheap: each line
+ * is its own Label and a Label builds its quads
+ * only when its text actually changes, so most
+ * frames just draw the cached quads.
+ */
+class PerfOverlay : public IRenderable
+{
+	// Fields
+public:
+protected:
+private:
+	SDL_Rect rect;	//	Background panel
+	const SDL_Color color;
+	Label lines[PERF_OVERLAY_LINES];
+	bool visible = false;
+	Uint64 lastRefresh = 0;	//	Ticks of the last refresh (ms)
+	Uint64 lastRefreshFrame = 0;	//	Profiler frame count at the last refresh
+	// Constructors
+public:
+	PerfOverlay(int x, int y);
+protected:
+private:
+	// Methods
+public:
+	__inline bool IsVisible() const { return visible; }
+	void SetVisible(bool newVisible);
+	__inline void Toggle() { SetVisible(!visible); }
+
+	//	IRenderable implementation
+	const SDL_Color & GetColor() const override { return color; }
+	const SDL_Rect GetRect() const override { return rect; }
+	void PreRender(SDL_Renderer * r) override;
+	void Render(SDL_Renderer * r) const override;
+protected:
+private:
+	//	Updates the texts with the latest figures
+	void Refresh();
+	//	Memory used by the process (resident set), in bytes, 0 if unknown
+	static Uint64 GetProcessMemory();
+};
@@ -4,6 +4,13 @@
 #include "Types.h"
 #include "Colors.h"
 #include "Input.h"
+#include "ReplayRecorder.h"
+#include "ReplayPlayer.h"
+#include "DirtyRects.h"
+#pragma endregion
+
+#pragma region Game Includes
+#include "PongRules.h"
 #pragma endregion
 
 #pragma region Constant Parameters
@@ -13,17 +20,6 @@
 #else
 #define SPLASH_DURATION 2500
 #endif
-//	Field layout metrics
-#define BORDERS_SIZE 10
-#define CENTERLINE_SIZE 2
-#define GOALS_SIZE 5
-//	Gameplay layout metrics
-#define BALL_SIZE 10
-#define BALL_SPEED 8
-#define PADDLES_SIZE 100
-#define PADDLES_SPEED 5
-#define PADDLES_GOAL_DISTANCE 30
-#define PADDLES_BORDER_OFFSET (GOALS_SIZE + PADDLES_GOAL_DISTANCE + BALL_SIZE / 2)
 //	HUD metrics
 #define SCORE_FONT_SIZE 72
 #define SCORE_TOP BORDERS_SIZE * 3
@@ -32,33 +28,50 @@
 #pragma endregion
 
 
-PongGame::PongGame(const int & viewportWidth, const int & viewportHeight) :
+PongGame::PongGame(const int & viewportWidth, const int & viewportHeight, const bool & headless, const int & tickRate, const Uint64 & seed) :
+	headless(headless),
+	tickRate(tickRate),
+	seed(seed),
+	random(seed),
 	viewport{0, 0, viewportWidth, viewportHeight},
-	topBorder{viewportWidth, BORDERS_SIZE},
-	bottomBorder{viewportWidth, BORDERS_SIZE},
-	centerLine{CENTERLINE_SIZE, viewportHeight},
-	goalP1{GOALS_SIZE, viewportHeight},
-	goalP2{GOALS_SIZE, viewportHeight},
-	padP1{BALL_SIZE, PADDLES_SIZE, PADDLES_SPEED},
-	padP2{BALL_SIZE, PADDLES_SIZE, PADDLES_SPEED},
-	ball{BALL_SIZE, BALL_SIZE, BALL_SPEED},
+	world{},
+	topBorder{world, viewportWidth, BORDERS_SIZE},
+	bottomBorder{world, viewportWidth, BORDERS_SIZE},
+	centerLine{world, CENTERLINE_SIZE, viewportHeight},
+	goalP1{world, GOALS_SIZE, viewportHeight},
+	goalP2{world, GOALS_SIZE, viewportHeight},
+	padP1{world, BALL_SIZE, PADDLES_SIZE, RULES_SCALE_SPEED(PADDLES_SPEED, tickRate)},
+	padP2{world, BALL_SIZE, PADDLES_SIZE, RULES_SCALE_SPEED(PADDLES_SPEED, tickRate)},
+	ball{world, BALL_SIZE, BALL_SIZE, RULES_SCALE_SPEED(BALL_SPEED, tickRate)},
+	staticLayer
+	{
+		viewportWidth,
+		viewportHeight,
+		{
+#ifdef _DEBUG
+			//	Display goals for debug
+			&goalP1,
+			&goalP2,
+#endif
+			&centerLine,
+			&topBorder,
+			&bottomBorder
+		}
+	},
 	scoreLabelP1{to_string(scoreP1), SCORE_FONT_SIZE},
 	scoreLabelP2{to_string(scoreP2), SCORE_FONT_SIZE},
+	perfOverlay{BORDERS_SIZE * 2, BORDERS_SIZE * 2},
 	renderQueue
 	{
-#ifdef _DEBUG
 		/*
-		 * Renderables added here are rendered
-		 * behind of everyting and only in
-		 * debug builds.
+		 * Centerline, borders and, in debug builds,
+		 * goals behind all: they never move, so they
+		 * are drawn once in the static layer. The
+		 * ball and the pads never overlap the borders,
+		 * so borders can stay behind them.
 		 */
-		//	Display goals for debug
-		&goalP1,
-		&goalP2,
-#endif
-		//	Centerline behind all
-		&centerLine,
-		//	Score behind all but centerline
+		&staticLayer,
+		//	Score behind all but the static layer
 		&scoreLabelP1,
 		&scoreLabelP2,
 		//	Ball behind pads
@@ -66,50 +79,51 @@ PongGame::PongGame(const int & viewportWidth, const int & viewportHeight) :
 		//	Pads above ball
 		&padP1,
 		&padP2,
-		//	Borders above all
-		&topBorder,
-		&bottomBorder
+		//	Performance overlay above everything
+		&perfOverlay
 	},
 	color(SDLC_CLEAR)	//	Unused
 {
 	//	Initialize field elements
-	topBorder.GetTransform()->pivot = Vector2F(0.5f, 0.0f);
-	topBorder.GetTransform()->position = Vector2(viewportWidth / 2, 0);
-	bottomBorder.GetTransform()->pivot = Vector2F(0.5f, 1.0f);
-	bottomBorder.GetTransform()->position = Vector2(viewportWidth / 2, viewportHeight);
-	centerLine.GetTransform()->position = Vector2(viewportWidth / 2, viewportHeight / 2);
+	topBorder.SetPivot(Vector2F(0.5f, 0.0f));
+	topBorder.SetPosition(Vector2(viewportWidth / 2, 0));
+	bottomBorder.SetPivot(Vector2F(0.5f, 1.0f));
+	bottomBorder.SetPosition(Vector2(viewportWidth / 2, viewportHeight));
+	centerLine.SetPosition(Vector2(viewportWidth / 2, viewportHeight / 2));
 	centerLine.SetColor(SDLC_GRAY);
 
 	//	Initialize gameplay elements
-	goalP1.GetTransform()->pivot = Vector2F(0.0f, 0.5f);
-	goalP1.GetTransform()->position = Vector2(0, viewportHeight / 2);
+	goalP1.SetPivot(Vector2F(0.0f, 0.5f));
+	goalP1.SetPosition(Vector2(0, viewportHeight / 2));
 #ifdef _DEBUG
 	goalP1.SetColor(SDLC_GREEN);
 #endif
-	goalP2.GetTransform()->pivot = Vector2F(1.0f, 0.5f);
-	goalP2.GetTransform()->position = Vector2(viewportWidth, viewportHeight / 2);
+	goalP2.SetPivot(Vector2F(1.0f, 0.5f));
+	goalP2.SetPosition(Vector2(viewportWidth, viewportHeight / 2));
 #ifdef _DEBUG
 	goalP2.SetColor(SDLC_GREEN);
 #endif
-	padP1.GetTransform()->position = Vector2(PADDLES_BORDER_OFFSET, viewportHeight / 2);
-	padP1.SetLimits(5 + BORDERS_SIZE, viewportHeight - 5 - BORDERS_SIZE);
-	padP1.SetControl(upKeyP1, downKeyP1);
-	padP2.GetTransform()->position = Vector2(viewportWidth - PADDLES_BORDER_OFFSET, viewportHeight / 2);
-	padP2.SetLimits(5 + BORDERS_SIZE, viewportHeight - 5 - BORDERS_SIZE);
-	padP2.SetControl(upKeyP2, downKeyP2);
+	padP1.SetPosition(Vector2(PADDLES_BORDER_OFFSET, viewportHeight / 2));
+	padP1.SetLimits(PADDLES_LIMIT_OFFSET, viewportHeight - PADDLES_LIMIT_OFFSET);
+	padP2.SetPosition(Vector2(viewportWidth - PADDLES_BORDER_OFFSET, viewportHeight / 2));
+	padP2.SetLimits(PADDLES_LIMIT_OFFSET, viewportHeight - PADDLES_LIMIT_OFFSET);
 	ball.SetColor(200, 50, 50);
+	ball.SetMaxSpeed(RULES_SCALE_SPEED(BALL_MAX_SPEED, tickRate));
 	PlaceBallToCenter();
 
 	//	Initialize collision detection
 	ball.AddGoal(&goalP1);
 	ball.AddGoal(&goalP2);
 
-	ball.AddPaddle(&padP1);
-	ball.AddPaddle(&padP2);
+	ball.AddPaddle(&padP1, true);
+	ball.AddPaddle(&padP2, false);
 
 	ball.AddObstacle(&topBorder);
 	ball.AddObstacle(&bottomBorder);
 
+	//	Everything is in place, nothing to interpolate from
+	world.BeginTick();
+
 	//	Initialize HUD
 	scoreLabelP1.GetTransform()->pivot = Vector2F(1.0f, 0.0f);
 	scoreLabelP1.GetTransform()->position  = Vector2(viewportWidth / 2 - BORDERS_SIZE, SCORE_TOP);
@@ -118,6 +132,19 @@ PongGame::PongGame(const int & viewportWidth, const int & viewportHeight) :
 	scoreLabelP2.GetTransform()->position  = Vector2(viewportWidth / 2 + BORDERS_SIZE, SCORE_TOP);
 	scoreLabelP2.SetColor(SDLC_GRAY);
 
+	/*
+	 * A headless game is only simulated (e.g. to
+	 * evaluate bots), so there's no audio device to
+	 * play sounds on and no renderer to show the
+	 * splash screen with: skip all media and jump
+	 * straight into the gameplay.
+	 */
+	if(headless)
+	{
+		splashScreen = nullptr;
+		return;
+	}
+
 	//	Initialize ball sounds
 	ball.SetObstacleSFX("HitObstacle");
 	ball.SetPaddleSFX("HitPaddle");
@@ -125,6 +152,20 @@ PongGame::PongGame(const int & viewportWidth, const int & viewportHeight) :
 
 	//	Initialize splahs screen
 	splashScreen = new SplashScreen(viewport, MEDIA_IMG_SPLASH_SCREEN, SPLASH_DURATION);
+	splashActive = true;
+
+	//	Rendering can start before the first update
+	Publish(0);
+}
+
+PongGame::~PongGame()
+{
+	//	The splash screen could still be alive if the game is disposed early
+	if(splashScreen)
+	{
+		delete splashScreen;
+		splashScreen = nullptr;
+	}
 }
 
 const SDL_Color & PongGame::GetColor() const
@@ -141,16 +182,52 @@ const SDL_Rect PongGame::GetRect() const
 
 void PongGame::PreRender(SDL_Renderer * r)
 {
+	//	Draw the latest state published (the same as the last frame, if the simulation didn't publish since)
+	renderStates.Acquire();
+	const PongRenderState & state = renderStates.GetFront();
+	world.SetRenderState(&state.world);
+
+	/*
+	 * Bodies are interpolated between the last two ticks
+	 * by the time passed since the last tick: what was
+	 * left over when the state was published, plus the
+	 * time passed since then.
+	 */
+	const long long tickNanos = 1000000000LL / tickRate;
+	const long long publishedNanos = (long long)((SDL_GetPerformanceCounter() - state.publishTime) * 1000000000.0 / SDL_GetPerformanceFrequency());
+	const long long sinceTickNanos = state.pendingNanos + publishedNanos;
+	world.SetRenderAlpha(sinceTickNanos < tickNanos ? (float)sinceTickNanos / tickNanos : 1.0f);
+
+	//	The splash screen covers the whole viewport, as long as it exists frames are full ones
+	if(splashScreen)
+		DirtyRects::Get().InvalidateAll();
+
 	//	Pre-render splash screen when active
 	if(
 		splashScreen &&
-		splashScreen->IsActive()
+		state.splashActive
 		)
+	{
 		splashScreen->PreRender(r);
-	else
-		//	Pre-render game after splash screen
-		for(IRenderable * const & renderable : renderQueue)
-			renderable->PreRender(r);
+		return;
+	}
+	//	If the simulation is past the splash screen but it still exists, delete it (it's released where it's drawn)
+	if(splashScreen)
+	{
+		delete splashScreen;
+		splashScreen = nullptr;
+	}
+
+	//	Bring the HUD up to date
+	if(state.scoreP1 != shownScoreP1)
+		scoreLabelP1.SetText(to_string(shownScoreP1 = state.scoreP1));
+	if(state.scoreP2 != shownScoreP2)
+		scoreLabelP2.SetText(to_string(shownScoreP2 = state.scoreP2));
+	perfOverlay.SetVisible(state.perfOverlayVisible);
+
+	//	Pre-render game after splash screen
+	for(IRenderable * const & renderable : renderQueue)
+		renderable->PreRender(r);
 }
 
 void PongGame::Render(SDL_Renderer * r) const
@@ -158,7 +235,7 @@ void PongGame::Render(SDL_Renderer * r) const
 	//	Render splash screen when active
 	if(
 		splashScreen &&
-		splashScreen->IsActive()
+		renderStates.GetFront().splashActive
 		)
 		splashScreen->Render(r);
 	else
@@ -169,36 +246,47 @@ void PongGame::Render(SDL_Renderer * r) const
 
 void PongGame::Update()
 {
-	//	If splash screen is active, update it
-	if(
-		splashScreen &&
-		splashScreen->IsActive()
-	)
+	//	Bodies' positions as of now are the starting point for interpolating this tick
+	world.BeginTick();
+
+	//	If splash screen is active, update it (once inactive, it's never touched again here)
+	if(splashActive)
 	{
 		splashScreen->Update();
+		splashActive = splashScreen->IsActive();
 		return;
 	}
-	//	If splash screen is inactive but still exists, delete it
-	if(splashScreen)
-	{
-		delete splashScreen;
-		splashScreen = nullptr;
-	}
 
 	/*
-	 * This approach is approximate as this
-	 * gets triggered every frame until the
-	 * kick off key is held.
-	 * It's working because the KickOff()
-	 * function checks the state of the ball
-	 * but in a real world scenario it would
-	 * be necessary to implement GetKeyUp()
-	 * and GetKeyDown().
+	 * All the simulation reads from the players goes
+	 * through a single tick input, so it can be recorded
+	 * or, when playing a replay, taken from the recording
+	 * (once over, nothing is pressed anymore).
 	 */
-	if(Input::Get().GetKey(kickOffKey))
-		ball.KickOff();
+	TickInput input = { };
+	if(!replayPlayer)
+		input = SampleInput();
+	else
+		replayPlayer->Read(input);
+	if(replayRecorder)
+		replayRecorder->Record(input);
+
+	/*
+	 * Holding the kick off key is enough, the ball
+	 * is kicked off again as soon as it's back in
+	 * the center (KickOff() does nothing while the
+	 * ball is moving).
+	 */
+	if(input.kickOff)
+		ball.KickOff(random);
+
+	//	Toggle the performance overlay when its key goes down (not while it's held), it doesn't affect the match
+	if(Input::Get().GetKeyDown(perfOverlayKey))
+		perfOverlayVisible = !perfOverlayVisible;
 
 	//	Feed update to single components
+	padP1.SetInput(input.held[RF_P1Up], input.held[RF_P1Down]);
+	padP2.SetInput(input.held[RF_P2Up], input.held[RF_P2Down]);
 	padP1.Update();
 	padP2.Update();
 	ball.Update();
@@ -206,17 +294,93 @@ void PongGame::Update()
 	//	Check game state
 	if(ball.HasPoint())
 	{
-		const Body * point = ball.ConsumePoint();
+		const BodyId point = ball.ConsumePoint();
 
-		if(point == &goalP2)
-			scoreLabelP1.SetText(to_string(++scoreP1));
-		else if(point == &goalP1)
-			scoreLabelP2.SetText(to_string(++scoreP2));
+		if(point == goalP2.GetId())
+			scoreP1++;
+		else if(point == goalP1.GetId())
+			scoreP2++;
 
 		PlaceBallToCenter();
 	}
 }
 
+void PongGame::Publish(long long pendingNanos)
+{
+	PongRenderState & state = renderStates.GetBack();
+	world.CaptureRenderState(state.world);
+	state.scoreP1 = scoreP1;
+	state.scoreP2 = scoreP2;
+	state.splashActive = splashActive;
+	state.perfOverlayVisible = perfOverlayVisible;
+	state.pendingNanos = pendingNanos;
+	state.publishTime = SDL_GetPerformanceCounter();
+	renderStates.Publish();
+}
+
+void PongGame::Save(PongSnapshot & snapshot) const
+{
+	world.SaveBody(padP1.GetId(), snapshot.paddles[0]);
+	world.SaveBody(padP2.GetId(), snapshot.paddles[1]);
+	world.SaveBody(ball.GetId(), snapshot.ball);
+	snapshot.ballPoint = ball.PeekPoint();
+	snapshot.scoreP1 = scoreP1;
+	snapshot.scoreP2 = scoreP2;
+	snapshot.reserved = 0;
+	snapshot.random = random.GetState();
+}
+
+void PongGame::Restore(const PongSnapshot & snapshot)
+{
+	world.RestoreBody(padP1.GetId(), snapshot.paddles[0]);
+	world.RestoreBody(padP2.GetId(), snapshot.paddles[1]);
+	world.RestoreBody(ball.GetId(), snapshot.ball);
+	ball.RestorePoint(snapshot.ballPoint);
+	scoreP1 = snapshot.scoreP1;
+	scoreP2 = snapshot.scoreP2;
+	random.SetState(snapshot.random);
+}
+
+Uint32 PongGame::GetChecksum() const
+{
+	//	FNV-1a over everything that evolves during a match
+	Uint32 hash = 2166136261u;
+	const auto mix = [&hash](Uint32 value)
+	{
+		for(int byte = 0; byte < 4; byte++)
+		{
+			hash ^= (value >> (byte * 8)) & 0xFF;
+			hash *= 16777619u;
+		}
+	};
+
+	mix(scoreP1);
+	mix(scoreP2);
+	for(const Body * body : {(const Body *)&padP1, (const Body *)&padP2, (const Body *)&ball})
+	{
+		mix(body->GetPosition().x);
+		mix(body->GetPosition().y);
+		mix(body->GetVelocity().x);
+		mix(body->GetVelocity().y);
+	}
+	const RandomState & randomState = random.GetState();
+	mix((Uint32)randomState.state);
+	mix((Uint32)(randomState.state >> 32));
+
+	return hash;
+}
+
+TickInput PongGame::SampleInput() const
+{
+	TickInput input;
+	input.held[RF_P1Up] = Input::Get().GetKeyHeldFraction(upKeyP1);
+	input.held[RF_P1Down] = Input::Get().GetKeyHeldFraction(downKeyP1);
+	input.held[RF_P2Up] = Input::Get().GetKeyHeldFraction(upKeyP2);
+	input.held[RF_P2Down] = Input::Get().GetKeyHeldFraction(downKeyP2);
+	input.kickOff = Input::Get().GetKey(kickOffKey);
+	return input;
+}
+
 void PongGame::PlaceBallToCenter()
 {
 	ball.Place(viewport.w / 2, viewport.h / 2);
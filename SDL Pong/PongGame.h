@@ -12,22 +12,75 @@
 #include "IRenderable.h"
 #include "IUpdatable.h"
 #include "Label.h"
+#include "World.h"
+#include "PerfOverlay.h"
+#include "StaticLayer.h"
+#include "TripleBuffer.h"
+#include "Random.h"
+#include "ReplayFormat.h"
 #pragma endregion
 
 #pragma region Game Includes
+#include "PongRules.h"
 #include "SplashScreen.h"
 #include "Body.h"
 #include "Paddle.h"
 #include "Ball.h"
 #pragma endregion
 
+/*
+ * State of a match, everything the simulation changes
+ * while it runs (see PongGame::Save()).
+ * It's plain data with no pointers (bodies and goals
+ * are referred to by id) and no padding, so it can be
+ * copied, stored or compared as raw bytes and saving
+ * or restoring it never allocates.
+ */
+typedef struct
+{
+	BodySnapshot paddles[2];	//	P1, P2
+	BodySnapshot ball;
+	BodyId ballPoint;	//	Goal the ball reached and not scored yet, NO_BODY if none
+	Sint32 scoreP1;
+	Sint32 scoreP2;
+	Sint32 reserved;	//	Keeps the random state aligned with no padding
+	RandomState random;
+} PongSnapshot;
+
+//	What rendering needs to know about the game, published by the simulation after its ticks
+typedef struct
+{
+	WorldRenderState world;
+	int scoreP1;
+	int scoreP2;
+	bool splashActive;
+	bool perfOverlayVisible;
+	long long pendingNanos;	//	Time already passed after the last tick when the state was published
+	Uint64 publishTime;	//	Performance counter value when the state was published
+} PongRenderState;
+
+/*
+ * The game is simulated by Update() and drawn by
+ * PreRender() and Render(), which may run on
+ * different threads: the simulation never touches
+ * what's being drawn, it publishes a copy of what
+ * rendering needs (see Publish()) and rendering only
+ * reads the latest copy published.
+ */
 class PongGame : public IRenderable, public IUpdatable
 {
 	// Fields
 public:
 protected:
 private:
+	const bool headless;	//	When true, the game is simulated only: no media is loaded and nothing is expected to be rendered
+	const int tickRate;	//	Updates per second, speeds are scaled to it
+	const Uint64 seed;	//	The whole match can be played again from this (given the same inputs)
+	Random random;	//	Every random choice of the match comes from here
+	class ReplayRecorder * replayRecorder = nullptr;	//	When set, the input of each tick is recorded
+	class ReplayPlayer * replayPlayer = nullptr;	//	When set, the input of each tick comes from here instead of the players
 	SDL_Rect viewport;
+	World world;	//	Stores the state of all bodies, must be declared (so initialized) before them
 	Body topBorder;
 	Body bottomBorder;
 	Body centerLine;
@@ -36,28 +89,38 @@ private:
 	Paddle padP1;
 	Paddle padP2;
 	Ball ball;
+	StaticLayer staticLayer;	//	Bodies that never move, drawn with a single copy
 	int scoreP1 = 0;
 	int scoreP2 = 0;
 	Label scoreLabelP1;
 	Label scoreLabelP2;
+	int shownScoreP1 = 0;	//	Scores the labels show, updated when rendering
+	int shownScoreP2 = 0;
+	PerfOverlay perfOverlay;
+	bool perfOverlayVisible = false;	//	Requested by the simulation, applied when rendering
+
+	SplashScreen * splashScreen;	//	Disposed when rendering, once the simulation is past it
+	bool splashActive = false;	//	Simulation side, the splash screen is only touched while active
 
-	SplashScreen * splashScreen;
+	TripleBuffer<PongRenderState> renderStates;
 
 	const vector<IRenderable *> renderQueue;
 	const SDL_Color color;	//	Unused
 
 #pragma region Input Mapping
 	/*	KEY MAPPING	*/
-	const SDL_Keycode upKeyP1 = SDLK_w;			//	Player 1 UP
-	const SDL_Keycode downKeyP1 = SDLK_s;		//	Player 1 DOWN
-	const SDL_Keycode upKeyP2 = SDLK_i;			//	Player 2 UP
-	const SDL_Keycode downKeyP2 = SDLK_k;		//	Player 2 DOWN
-	const SDL_Keycode kickOffKey = SDLK_SPACE;	//	Shared Kick-Off
+	const SDL_Scancode upKeyP1 = SDL_SCANCODE_W;			//	Player 1 UP
+	const SDL_Scancode downKeyP1 = SDL_SCANCODE_S;			//	Player 1 DOWN
+	const SDL_Scancode upKeyP2 = SDL_SCANCODE_I;			//	Player 2 UP
+	const SDL_Scancode downKeyP2 = SDL_SCANCODE_K;			//	Player 2 DOWN
+	const SDL_Scancode kickOffKey = SDL_SCANCODE_SPACE;		//	Shared Kick-Off
+	const SDL_Scancode perfOverlayKey = SDL_SCANCODE_F3;	//	Show/hide performance overlay
 	/*	===========	*/
 #pragma endregion
 	// Constructors
 public:
-	PongGame(const int & viewportWidth, const int & viewportHeight);
+	PongGame(const int & viewportWidth, const int & viewportHeight, const bool & headless = false, const int & tickRate = RULES_TICK_RATE, const Uint64 & seed = 0);
+	~PongGame();
 protected:
 private:
 	// Methods
@@ -70,8 +133,34 @@ public:
 
 	//	IUpdatable impementation
 	void Update() override;
+
+	__inline bool IsHeadless() const { return headless; }
+	__inline int GetTickRate() const { return tickRate; }
+	__inline Uint64 GetSeed() const { return seed; }
+	//	Makes the state as of the last update available to rendering, pendingNanos is the time passed since that update
+	void Publish(long long pendingNanos);
+	__inline int GetScoreP1() const { return scoreP1; }
+	__inline int GetScoreP2() const { return scoreP2; }
+	//	Neither is owned, they must outlive the game (or be unset)
+	__inline void SetReplayRecorder(class ReplayRecorder * recorder) { replayRecorder = recorder; }
+	__inline void SetReplayPlayer(class ReplayPlayer * player) { replayPlayer = player; }
+	/*
+	 * Save() copies the state of the match, Restore()
+	 * brings the match back to it: the next updates go
+	 * on exactly as they did after the save (given the
+	 * same inputs), e.g. to roll back and simulate again
+	 * or to explore different inputs from the same state.
+	 * Only the match is saved, not the splash screen nor
+	 * what's being recorded or played back.
+	 */
+	void Save(PongSnapshot & snapshot) const;
+	void Restore(const PongSnapshot & snapshot);
+	//	Hash of the state of the match, two matches with the same checksum (almost surely) ended up in the same state
+	Uint32 GetChecksum() const;
 protected:
 private:
+	//	What the players did during the current tick
+	TickInput SampleInput() const;
 	void PlaceBallToCenter();
 };
 
@@ -0,0 +1,65 @@
+#pragma once
+
+/*
+ * This file contains the rules of the game, i.e.
+ * the metrics of the field and of the gameplay
+ * elements.
+ * They're shared by everything that simulates a
+ * match (the game itself and the batch simulator)
+ * so that all simulations follow the same rules.
+ */
+
+#pragma region Engine Includes
+#include "Fixed.h"
+#pragma endregion
+
+//	Field layout metrics
+#define BORDERS_SIZE 10
+#define CENTERLINE_SIZE 2
+#define GOALS_SIZE 5
+//	Gameplay layout metrics
+#define BALL_SIZE 10
+#define BALL_SPEED 8
+#define PADDLES_SIZE 100
+#define PADDLES_SPEED 5
+#define PADDLES_GOAL_DISTANCE 30
+#define PADDLES_BORDER_OFFSET (GOALS_SIZE + PADDLES_GOAL_DISTANCE + BALL_SIZE / 2)
+#define PADDLES_LIMIT_OFFSET (5 + BORDERS_SIZE)
+
+/*
+ * Speeds above are in pixels per tick, at this tick
+ * rate. Simulations running at a different rate scale
+ * them to cover the same distance per second, in fixed
+ * point (see Fixed.h): any rate keeps the speed down
+ * to a fraction of a pixel per tick.
+ */
+#define RULES_TICK_RATE 60
+#define RULES_SCALE_SPEED(speed, tickRate) ((Fixed)((Sint64)(speed) * FIXED_ONE * RULES_TICK_RATE / (tickRate)))
+#define RULES_PERCENT(percent) ((Fixed)((Sint64)(percent) * FIXED_ONE / 100))
+
+//	Paddle returns
+#define BALL_MAX_SPEED 16	//	Horizontal speed never goes beyond this (same units as BALL_SPEED)
+#define BALL_SPEED_UP_PERCENT 5	//	Speed gained on each paddle return
+#define BALL_DEFLECTION_PERCENT 75	//	Vertical speed gained hitting the very edge of a paddle, relative to the horizontal speed
+#define BALL_MAX_SLOPE_PERCENT 150	//	Vertical speed never goes beyond this, relative to the horizontal speed
+
+/*
+ * Velocity of the ball after a paddle returns it: the
+ * horizontal speed is flipped and ramps up, the
+ * vertical one is deflected by how far from the center
+ * of the paddle the ball hit it (the reach is how far
+ * the centers can be while touching), so returns get
+ * steeper towards the edges.
+ * Only clamps and multiplications, no branches on the
+ * state of the ball, so simulations stepping many
+ * balls at once can run it on all of them alike.
+ */
+__inline FixedVector2 RulesPaddleReturn(FixedVector2 velocity, Fixed ballCenter, Fixed paddleCenter, Fixed reach, Fixed maxSpeed)
+{
+	const Fixed offset = FixedClamp(FixedDiv(ballCenter - paddleCenter, reach), -FIXED_ONE, FIXED_ONE);
+	const Fixed speedX = FixedMin(FixedMul(FixedAbs(velocity.x), FIXED_ONE + RULES_PERCENT(BALL_SPEED_UP_PERCENT)), maxSpeed);
+	const Fixed maxSpeedY = FixedMul(speedX, RULES_PERCENT(BALL_MAX_SLOPE_PERCENT));
+	const Fixed speedY = FixedMul(velocity.y, FIXED_ONE + RULES_PERCENT(BALL_SPEED_UP_PERCENT)) + FixedMul(FixedMul(offset, RULES_PERCENT(BALL_DEFLECTION_PERCENT)), speedX);
+
+	return FixedVector2(velocity.x < 0 ? speedX : -speedX, FixedClamp(speedY, -maxSpeedY, maxSpeedY));
+}
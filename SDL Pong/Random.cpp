@@ -0,0 +1,41 @@
+#include "Random.h"
+
+Random::Random(Uint64 seed, Uint64 stream)
+{
+	Seed(seed, stream);
+}
+
+void Random::Seed(Uint64 seed, Uint64 stream)
+{
+	//	Same seeding as the reference implementation, so sequences can be checked against it
+	state.state = 0;
+	state.increment = (stream << 1) | 1;
+	Next();
+	state.state += seed;
+	Next();
+}
+
+Uint32 Random::Below(Uint32 bound)
+{
+	/*
+	 * Scaling a 32 bits number by the bound, the high
+	 * half of the product is the result. Some results
+	 * would come up once more than others (unless the
+	 * bound is a power of 2), the low half tells when
+	 * the number falls in the few values to reject.
+	 * No division in the common case.
+	 */
+	Uint64 product = (Uint64)Next() * bound;
+	Uint32 low = (Uint32)product;
+	if(low < bound)
+	{
+		const Uint32 threshold = (0u - bound) % bound;
+		while(low < threshold)
+		{
+			product = (Uint64)Next() * bound;
+			low = (Uint32)product;
+		}
+	}
+
+	return (Uint32)(product >> 32);
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#pragma region SDL Includes
+#include "SDL_stdinc.h"
+#pragma endregion
+
+//	State of a random stream, plain data so it can be copied and stored along with the rest of a game state
+typedef struct
+{
+	Uint64 state;
+	Uint64 increment;	//	Selects the stream, always odd
+} RandomState;
+
+/*
+ * Pseudo-random number generator (PCG32, see
+ * pcg-random.org) for everything the simulation
+ * randomizes.
+ * A generator is seeded once and gives the very same
+ * sequence of numbers from the same seed, on every
+ * machine, so a match can be played again exactly
+ * from its seed (and its inputs). The same seed can
+ * also drive independent streams (e.g. one per match
+ * of a batch), which never overlap.
+ * It's as small as its state (16 bytes, no heap) and
+ * each number is a multiply-add and a rotation, so
+ * keeping one for each match is cheap and drawing
+ * from it never hits the system like random_device
+ * does.
+ */
+class Random
+{
+	// Fields
+public:
+protected:
+private:
+	RandomState state;
+	// Constructors
+public:
+	Random(Uint64 seed = 0, Uint64 stream = 0);
+protected:
+private:
+	// Methods
+public:
+	//	Restarts the sequence of the given seed and stream
+	void Seed(Uint64 seed, Uint64 stream = 0);
+	__inline Uint32 Next()
+	{
+		const Uint64 previous = state.state;
+		state.state = previous * 6364136223846793005ULL + state.increment;
+
+		//	Output is a permutation of the previous state: xorshift, then a rotation chosen by the top bits
+		const Uint32 shifted = (Uint32)(((previous >> 18) ^ previous) >> 27);
+		const Uint32 rotation = (Uint32)(previous >> 59);
+		return (shifted >> rotation) | (shifted << ((0u - rotation) & 31));
+	}
+	//	Uniform in [0, bound), with no modulo bias (bound must not be 0)
+	Uint32 Below(Uint32 bound);
+	//	Uniform in [min, max]
+	__inline int Range(int min, int max) { return min + (int)Below((Uint32)(max - min) + 1); }
+	__inline const RandomState & GetState() const { return state; }
+	__inline void SetState(const RandomState & newState) { state = newState; }
+protected:
+private:
+};
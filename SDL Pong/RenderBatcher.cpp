@@ -0,0 +1,81 @@
+#include "RenderBatcher.h"
+
+void RenderBatcher::FillRect(const SDL_Rect & rect, const SDL_Color & color)
+{
+	if(rect.w <= 0 || rect.h <= 0)
+		return;
+
+	/*
+	 * Alpha is ignored unless blending is on, so
+	 * translucent colors are blended and opaque ones
+	 * just overwrite the target (the cheaper option).
+	 */
+	const SDL_BlendMode blendMode = color.a < 255 ? SDL_BLENDMODE_BLEND : SDL_BLENDMODE_NONE;
+	rectCount++;
+
+	//	Walk back to the latest batch with the same state, as long as nothing drawn after it is covered by rect
+	for(size_t i = activeBatches; i-- > 0;)
+	{
+		Batch & batch = batches[i];
+		if(SameState(batch, color, blendMode))
+		{
+			batch.rects.push_back(rect);
+			SDL_UnionRect(&batch.bounds, &rect, &batch.bounds);
+			return;
+		}
+
+		if(SDL_HasIntersection(&batch.bounds, &rect))
+		{
+			bool overlaps = false;
+			for(const SDL_Rect & queued : batch.rects)
+				if(SDL_HasIntersection(&queued, &rect))
+				{
+					overlaps = true;
+					break;
+				}
+			if(overlaps)
+				break;
+		}
+	}
+
+	//	Start a new batch at the end, reusing the memory of a previous frame when possible
+	if(activeBatches == batches.size())
+		batches.push_back(Batch());
+	Batch & batch = batches[activeBatches++];
+	batch.color = color;
+	batch.blendMode = blendMode;
+	batch.bounds = rect;
+	batch.rects.clear();
+	batch.rects.push_back(rect);
+}
+
+void RenderBatcher::Flush(SDL_Renderer * r)
+{
+	for(size_t i = 0; i < activeBatches; i++)
+	{
+		const Batch & batch = batches[i];
+		SDL_SetRenderDrawColor(r, batch.color.r, batch.color.g, batch.color.b, batch.color.a);
+		SDL_SetRenderDrawBlendMode(r, batch.blendMode);
+		SDL_RenderFillRects(r, batch.rects.data(), (int)batch.rects.size());
+		drawCalls++;
+	}
+	activeBatches = 0;
+}
+
+void RenderBatcher::EndFrame()
+{
+	lastFrameDrawCalls = drawCalls;
+	lastFrameRectCount = rectCount;
+	drawCalls = 0;
+	rectCount = 0;
+}
+
+bool RenderBatcher::SameState(const Batch & batch, const SDL_Color & color, SDL_BlendMode blendMode)
+{
+	return
+		batch.blendMode == blendMode &&
+		batch.color.r == color.r &&
+		batch.color.g == color.g &&
+		batch.color.b == color.b &&
+		batch.color.a == color.a;
+}
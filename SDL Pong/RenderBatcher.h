@@ -0,0 +1,77 @@
+#pragma once
+
+#pragma region C++ Includes
+#include <vector>
+#pragma endregion
+
+#pragma region SDL Includes
+#include "SDL.h"
+#pragma endregion
+
+using namespace std;
+
+/*
+ * Collects filled rectangles and draws them in as few
+ * calls as possible: rectangles sharing color and blend
+ * mode are drawn together with SDL_RenderFillRects(),
+ * so the draw state is set once per group, not once
+ * per rectangle.
+ * Draw order is preserved where it matters: a rectangle
+ * joins an earlier group with its same state only if
+ * it doesn't overlap anything queued after that group,
+ * otherwise it starts a new group at the end.
+ * Anything drawing directly on the renderer (textures,
+ * geometry) must Flush() first, so queued rectangles
+ * end up behind it. The main loop flushes whatever is
+ * left before presenting.
+ */
+class RenderBatcher
+{
+	// Fields
+public:
+protected:
+private:
+	typedef struct
+	{
+		SDL_Color color;
+		SDL_BlendMode blendMode;
+		SDL_Rect bounds;	//	Union of the rects, to skip overlap tests quickly
+		vector<SDL_Rect> rects;
+	} Batch;
+
+	vector<Batch> batches;
+	size_t activeBatches = 0;	//	Batches in use, the rest are kept to reuse their memory
+	//	Statistics, of the frame being drawn and of the last complete one
+	int drawCalls = 0;
+	int rectCount = 0;
+	int lastFrameDrawCalls = 0;
+	int lastFrameRectCount = 0;
+	// Constructors
+public:
+	// Delete copy constructor and assignment operator (singleton protection)
+	RenderBatcher(const RenderBatcher &) = delete;
+	RenderBatcher & operator=(const RenderBatcher &) = delete;
+protected:
+private:
+	RenderBatcher() { }
+	// Methods
+public:
+	static RenderBatcher & Get()
+	{
+		//	Singleton implementation
+		static RenderBatcher instance;
+		return instance;
+	}
+	//	Queues a filled rect, blended when color isn't fully opaque
+	void FillRect(const SDL_Rect & rect, const SDL_Color & color);
+	//	Draws all queued rects
+	void Flush(SDL_Renderer * r);
+	//	Closes the statistics of the frame, call after presenting it
+	void EndFrame();
+
+	__inline int GetDrawCalls() const { return lastFrameDrawCalls; }
+	__inline int GetRectCount() const { return lastFrameRectCount; }
+protected:
+private:
+	static bool SameState(const Batch & batch, const SDL_Color & color, SDL_BlendMode blendMode);
+};
@@ -0,0 +1,67 @@
+#pragma once
+
+#pragma region SDL Includes
+#include "SDL_stdinc.h"
+#pragma endregion
+
+#pragma region Engine Includes
+#include "Fixed.h"
+#pragma endregion
+
+/*
+ * Layout of a replay file (.rep): a header, followed
+ * by the inputs of all the ticks of a match.
+ * A match is deterministic, so the seed, the settings
+ * it was simulated with and its inputs are all it
+ * takes to play it again, exactly.
+ * Inputs are delta encoded: the stream is a sequence
+ * of records, each made of a change (a byte with a
+ * bit for each field that changed, plus the kick-off
+ * state, followed by the differences of the changed
+ * fields) and of the number of ticks after it with
+ * the same input, so ticks with no change (most of
+ * them) take nothing. Numbers in records are varints
+ * (7 bits per byte, low bits first, the high bit set
+ * when more bytes follow), differences are zigzag
+ * encoded so small negative ones stay small too.
+ * Numbers in the header are little endian (all
+ * supported targets are).
+ */
+
+#define REPLAY_MAGIC "SPRP"
+#define REPLAY_MAGIC_SIZE 4
+#define REPLAY_VERSION 1
+
+//	Fields of a tick input, in the order of the bits of a change
+typedef enum
+{
+	RF_P1Up		= 0,
+	RF_P1Down	= 1,
+	RF_P2Up		= 2,
+	RF_P2Down	= 3,
+	RF_Count	= 4
+} ReplayField;
+//	Bit of a change holding the kick-off state
+#define REPLAY_KICK_OFF_BIT (1 << RF_Count)
+
+//	What the simulation reads from the players on each tick, all a replay records
+typedef struct
+{
+	Fixed held[RF_Count];	//	From 0 to 1, how much of the tick each key was held for
+	bool kickOff;
+} TickInput;
+
+typedef struct
+{
+	char magic[REPLAY_MAGIC_SIZE];
+	Uint32 version;
+	Uint64 seed;
+	Sint32 tickRate;
+	Sint32 fieldWidth;
+	Sint32 fieldHeight;
+	Uint32 tickCount;
+	Sint32 scoreP1;	//	Final scores, to tell whether playing the replay gives the same outcome
+	Sint32 scoreP2;
+	Uint32 checksum;	//	Of the final state of the match (see PongGame::GetChecksum())
+	Uint32 streamSize;	//	Bytes of inputs following the header
+} ReplayHeader;
@@ -0,0 +1,124 @@
+#include "ReplayPlayer.h"
+
+#pragma region C++ Includes
+#include <iostream>
+#include <fstream>
+#include <cstring>
+#pragma endregion
+
+using namespace std;
+
+ReplayPlayer::ReplayPlayer()
+{
+	memset(&header, 0, sizeof(header));
+	memset(&last, 0, sizeof(last));
+}
+
+bool ReplayPlayer::Load(const string & path)
+{
+	ifstream file(path, ios::binary);
+	if(!file)
+	{
+		cout << "Couldn't open replay " << path << endl;
+		return false;
+	}
+
+	if(!file.read((char *)&header, sizeof(header)))
+	{
+		cout << "Replay " << path << " is truncated" << endl;
+		return false;
+	}
+	if(memcmp(header.magic, REPLAY_MAGIC, REPLAY_MAGIC_SIZE) != 0)
+	{
+		cout << path << " is not a replay" << endl;
+		return false;
+	}
+	if(header.version != REPLAY_VERSION)
+	{
+		cout << "Replay " << path << " has version " << header.version << ", only version " << REPLAY_VERSION << " is supported" << endl;
+		return false;
+	}
+	if(header.tickRate <= 0 || header.fieldWidth <= 0 || header.fieldHeight <= 0)
+	{
+		cout << "Replay " << path << " has invalid settings" << endl;
+		return false;
+	}
+
+	//	The stream must be all there, checked before allocating it (a corrupted size could ask for gigabytes)
+	const streamoff streamStart = file.tellg();
+	file.seekg(0, ios::end);
+	const streamoff fileEnd = file.tellg();
+	file.seekg(streamStart);
+	if(streamStart < 0 || fileEnd < streamStart || (Uint64)header.streamSize > (Uint64)(fileEnd - streamStart))
+	{
+		cout << "Replay " << path << " is truncated" << endl;
+		return false;
+	}
+
+	stream.resize(header.streamSize);
+	if(!stream.empty() && !file.read((char *)stream.data(), stream.size()))
+	{
+		cout << "Replay " << path << " is truncated" << endl;
+		return false;
+	}
+
+	//	Start from the first tick
+	cursor = 0;
+	memset(&last, 0, sizeof(last));
+	repeats = 0;
+	ticksRead = 0;
+	corrupted = false;
+	return true;
+}
+
+bool ReplayPlayer::Read(TickInput & input)
+{
+	if(IsOver())
+		return false;
+
+	//	Past the run of the last change, decode the next one
+	if(repeats > 0)
+		repeats--;
+	else
+	{
+		if(cursor >= stream.size())
+		{
+			corrupted = true;
+			return false;
+		}
+		const Uint8 change = stream[cursor++];
+		for(int field = 0; field < RF_Count; field++)
+			if(change & (1 << field))
+			{
+				Uint32 zigzag;
+				if(!ReadVarint(zigzag))
+					return false;
+				last.held[field] += (Sint32)((zigzag >> 1) ^ (0u - (zigzag & 1)));
+			}
+		last.kickOff = (change & REPLAY_KICK_OFF_BIT) != 0;
+		if(!ReadVarint(repeats))
+			return false;
+	}
+
+	input = last;
+	ticksRead++;
+	return true;
+}
+
+bool ReplayPlayer::ReadVarint(Uint32 & value)
+{
+	value = 0;
+	for(int shift = 0; shift < 35; shift += 7)
+	{
+		if(cursor >= stream.size())
+			break;
+		const Uint8 byte = stream[cursor++];
+		value |= (Uint32)(byte & 0x7F) << shift;
+		if(!(byte & 0x80))
+			return true;
+	}
+
+	//	Ran out of bytes (or too many of them) in the middle of a number
+	corrupted = true;
+	return false;
+}
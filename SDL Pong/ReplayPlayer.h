@@ -0,0 +1,53 @@
+#pragma once
+
+#pragma region C++ Includes
+#include <vector>
+#include <string>
+#pragma endregion
+
+#pragma region Engine Includes
+#include "ReplayFormat.h"
+#pragma endregion
+
+using namespace std;
+
+/*
+ * Plays a replay back (see ReplayFormat.h): gives the
+ * inputs of its ticks, one by one, in place of the
+ * players, to a game set up with the replay's seed
+ * and settings.
+ * The whole file is loaded at once, inputs are
+ * decoded as they're read.
+ */
+class ReplayPlayer
+{
+	// Fields
+public:
+protected:
+private:
+	ReplayHeader header;
+	vector<Uint8> stream;
+	size_t cursor = 0;	//	Next byte of the stream to decode
+	TickInput last;	//	Input of the last tick read
+	Uint32 repeats = 0;	//	Ticks left with the same input as the last one
+	Uint32 ticksRead = 0;
+	bool corrupted = false;
+	// Constructors
+public:
+	ReplayPlayer();
+protected:
+private:
+	// Methods
+public:
+	//	Reads a replay file, returns false (and reports why) if it can't be played
+	bool Load(const string & path);
+	__inline const ReplayHeader & GetHeader() const { return header; }
+	//	Gives the input of the next tick, returns false once all the ticks have been read
+	bool Read(TickInput & input);
+	__inline bool IsOver() const { return ticksRead >= header.tickCount || corrupted; }
+	__inline Uint32 GetTicksRead() const { return ticksRead; }
+	__inline bool IsCorrupted() const { return corrupted; }
+protected:
+private:
+	bool ReadVarint(Uint32 & value);
+};
@@ -0,0 +1,94 @@
+#include "ReplayRecorder.h"
+
+#pragma region C++ Includes
+#include <iostream>
+#include <fstream>
+#include <cstring>
+#pragma endregion
+
+using namespace std;
+
+ReplayRecorder::ReplayRecorder(Uint64 seed, int tickRate, int fieldWidth, int fieldHeight)
+{
+	memset(&header, 0, sizeof(header));
+	memcpy(header.magic, REPLAY_MAGIC, REPLAY_MAGIC_SIZE);
+	header.version = REPLAY_VERSION;
+	header.seed = seed;
+	header.tickRate = tickRate;
+	header.fieldWidth = fieldWidth;
+	header.fieldHeight = fieldHeight;
+
+	//	The first tick is a change from no input at all
+	memset(&last, 0, sizeof(last));
+}
+
+void ReplayRecorder::Record(const TickInput & input)
+{
+	//	Find what changed since the last tick
+	Uint8 change = input.kickOff ? REPLAY_KICK_OFF_BIT : 0;
+	for(int field = 0; field < RF_Count; field++)
+		if(input.held[field] != last.held[field])
+			change |= 1 << field;
+
+	//	Same input, it only extends the run of the last change
+	if(header.tickCount > 0 && change == (last.kickOff ? REPLAY_KICK_OFF_BIT : 0))
+	{
+		repeats++;
+		header.tickCount++;
+		return;
+	}
+
+	//	Close the run of the previous change, then write this one
+	if(header.tickCount > 0)
+		WriteVarint(stream, repeats);
+	stream.push_back(change);
+	for(int field = 0; field < RF_Count; field++)
+		if(change & (1 << field))
+		{
+			const Sint32 delta = input.held[field] - last.held[field];
+			WriteVarint(stream, ((Uint32)delta << 1) ^ (Uint32)(delta >> 31));
+		}
+
+	last = input;
+	repeats = 0;
+	header.tickCount++;
+}
+
+bool ReplayRecorder::Save(const string & path, int scoreP1, int scoreP2, Uint32 checksum)
+{
+	//	The run of the last change is still open, close it in a copy so recording can go on
+	vector<Uint8> closedStream = stream;
+	if(header.tickCount > 0)
+		WriteVarint(closedStream, repeats);
+
+	header.scoreP1 = scoreP1;
+	header.scoreP2 = scoreP2;
+	header.checksum = checksum;
+	header.streamSize = (Uint32)closedStream.size();
+
+	ofstream file(path, ios::binary);
+	if(!file)
+	{
+		cout << "Couldn't create replay " << path << endl;
+		return false;
+	}
+	file.write((const char *)&header, sizeof(header));
+	file.write((const char *)closedStream.data(), closedStream.size());
+	if(!file)
+	{
+		cout << "Couldn't write replay " << path << endl;
+		return false;
+	}
+
+	return true;
+}
+
+void ReplayRecorder::WriteVarint(vector<Uint8> & destination, Uint32 value)
+{
+	while(value >= 0x80)
+	{
+		destination.push_back((Uint8)(value | 0x80));
+		value >>= 7;
+	}
+	destination.push_back((Uint8)value);
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#pragma region C++ Includes
+#include <vector>
+#include <string>
+#pragma endregion
+
+#pragma region Engine Includes
+#include "ReplayFormat.h"
+#pragma endregion
+
+using namespace std;
+
+/*
+ * Records the inputs of a match, tick by tick, and
+ * saves them as a replay (see ReplayFormat.h).
+ * Inputs are encoded as they come, in memory, so a
+ * tick costs a comparison and, only when something
+ * changed, a few bytes; the file is written once,
+ * when the match is over.
+ */
+class ReplayRecorder
+{
+	// Fields
+public:
+protected:
+private:
+	ReplayHeader header;
+	vector<Uint8> stream;
+	TickInput last;	//	Input of the last tick recorded
+	Uint32 repeats = 0;	//	Ticks after the last change with the same input
+	// Constructors
+public:
+	ReplayRecorder(Uint64 seed, int tickRate, int fieldWidth, int fieldHeight);
+protected:
+private:
+	// Methods
+public:
+	//	Appends the input of a tick
+	void Record(const TickInput & input);
+	__inline Uint32 GetTickCount() const { return header.tickCount; }
+	//	Writes the replay, with the outcome of the match, returns false on failure
+	bool Save(const string & path, int scoreP1, int scoreP2, Uint32 checksum);
+protected:
+private:
+	static void WriteVarint(vector<Uint8> & destination, Uint32 value);
+};
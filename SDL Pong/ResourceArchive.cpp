@@ -0,0 +1,212 @@
+#include "ResourceArchive.h"
+
+#pragma region C++ Includes
+#include <iostream>
+#include <cstring>
+#include <algorithm>
+#pragma endregion
+
+#pragma region Platform Includes
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+#pragma endregion
+
+#pragma region Engine Includes
+#include "Lz4.h"
+#pragma endregion
+
+bool ResourceArchive::Mount(const string & archivePath, const string & newRootPath)
+{
+	Unmount();
+
+	//	Map the whole file, read only
+#if defined(_WIN32)
+	fileHandle = CreateFileA(archivePath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if(fileHandle == INVALID_HANDLE_VALUE)
+	{
+		fileHandle = nullptr;
+		return false;
+	}
+	LARGE_INTEGER fileSize;
+	if(GetFileSizeEx(fileHandle, &fileSize) && fileSize.QuadPart > 0)
+	{
+		mappingHandle = CreateFileMappingA(fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		if(mappingHandle)
+		{
+			data = (const Uint8 *)MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0);
+			size = (size_t)fileSize.QuadPart;
+		}
+	}
+#else
+	const int file = open(archivePath.c_str(), O_RDONLY);
+	if(file < 0)
+		return false;
+	struct stat fileStat;
+	if(fstat(file, &fileStat) == 0 && fileStat.st_size > 0)
+	{
+		void * mapping = mmap(nullptr, (size_t)fileStat.st_size, PROT_READ, MAP_PRIVATE, file, 0);
+		if(mapping != MAP_FAILED)
+		{
+			data = (const Uint8 *)mapping;
+			size = (size_t)fileStat.st_size;
+		}
+	}
+	//	The mapping stays valid after closing the file
+	close(file);
+#endif
+	if(!data)
+	{
+		cout << "Couldn't map resource archive " << archivePath << endl;
+		UnmapFile();
+		return false;
+	}
+
+	//	Check everything the lookups rely on once, so they don't need to
+	bool valid = size >= sizeof(ArchiveHeader);
+	const ArchiveHeader * header = (const ArchiveHeader *)data;
+	if(valid)
+		valid =
+			memcmp(header->magic, ARCHIVE_MAGIC, ARCHIVE_MAGIC_SIZE) == 0 &&
+			header->version == ARCHIVE_VERSION &&
+			(size - sizeof(ArchiveHeader)) / sizeof(ArchiveEntry) >= header->entryCount &&
+			size - sizeof(ArchiveHeader) - header->entryCount * sizeof(ArchiveEntry) >= header->namesSize;
+	if(valid)
+	{
+		entries = (const ArchiveEntry *)(data + sizeof(ArchiveHeader));
+		entryCount = header->entryCount;
+		names = (const char *)(entries + entryCount);
+		for(Uint32 i = 0; i < entryCount && valid; i++)
+		{
+			const ArchiveEntry & entry = entries[i];
+			valid =
+				entry.nameOffset < header->namesSize &&
+				entry.nameLength < header->namesSize - entry.nameOffset &&
+				names[entry.nameOffset + entry.nameLength] == 0 &&
+				entry.offset <= size && entry.storedSize <= size - entry.offset &&
+				(entry.compression == AC_Lz4 || (entry.compression == AC_None && entry.size == entry.storedSize));
+		}
+	}
+	if(!valid)
+	{
+		cout << "Invalid resource archive " << archivePath << endl;
+		UnmapFile();
+		return false;
+	}
+
+	rootPath = newRootPath;
+	return true;
+}
+
+void ResourceArchive::Unmount()
+{
+	{
+		lock_guard<mutex> lock(inflatedMutex);
+		inflated.clear();
+	}
+	UnmapFile();
+}
+
+bool ResourceArchive::Find(const string & path, const void * & fileData, size_t & fileSize)
+{
+	if(!IsMounted())
+		return false;
+
+	const int index = FindEntry(GetEntryName(path));
+	if(index < 0)
+		return false;
+	const ArchiveEntry & entry = entries[index];
+
+	//	Stored as is: straight from the mapping
+	if(entry.compression == AC_None)
+	{
+		fileData = data + entry.offset;
+		fileSize = (size_t)entry.size;
+		return true;
+	}
+
+	//	Compressed: decompress once, later requests share the result
+	lock_guard<mutex> lock(inflatedMutex);
+	auto cached = inflated.find((Uint32)index);
+	if(cached == inflated.end())
+	{
+		vector<Uint8> contents((size_t)entry.size);
+		if(!Lz4::Decompress(data + entry.offset, (size_t)entry.storedSize, contents.data(), contents.size()))
+		{
+			cout << "Corrupted entry " << (names + entry.nameOffset) << " in resource archive" << endl;
+			return false;
+		}
+		cached = inflated.insert(make_pair((Uint32)index, move(contents))).first;
+	}
+	fileData = cached->second.data();
+	fileSize = cached->second.size();
+	return true;
+}
+
+SDL_RWops * ResourceArchive::Open(const string & path)
+{
+	const void * fileData;
+	size_t fileSize;
+	if(Find(path, fileData, fileSize))
+		return SDL_RWFromConstMem(fileData, (int)fileSize);
+
+	return SDL_RWFromFile(path.c_str(), "rb");
+}
+
+string ResourceArchive::GetEntryName(const string & path) const
+{
+	//	Paths outside of the packed directory keep their full path, and won't be found
+	string name = path.compare(0, rootPath.size(), rootPath) == 0 ? path.substr(rootPath.size()) : path;
+	replace(name.begin(), name.end(), '\\', '/');
+
+	return name;
+}
+
+int ResourceArchive::FindEntry(const string & name) const
+{
+	//	Entries are sorted by name, byte by byte
+	int first = 0;
+	int last = (int)entryCount - 1;
+	while(first <= last)
+	{
+		const int middle = first + (last - first) / 2;
+		const int comparison = strcmp(names + entries[middle].nameOffset, name.c_str());
+		if(comparison == 0)
+			return middle;
+		if(comparison < 0)
+			first = middle + 1;
+		else
+			last = middle - 1;
+	}
+
+	return -1;
+}
+
+void ResourceArchive::UnmapFile()
+{
+#if defined(_WIN32)
+	if(data)
+		UnmapViewOfFile(data);
+	if(mappingHandle)
+		CloseHandle(mappingHandle);
+	if(fileHandle)
+		CloseHandle(fileHandle);
+	mappingHandle = nullptr;
+	fileHandle = nullptr;
+#else
+	if(data)
+		munmap((void *)data, size);
+#endif
+	data = nullptr;
+	size = 0;
+	entries = nullptr;
+	entryCount = 0;
+	names = nullptr;
+}
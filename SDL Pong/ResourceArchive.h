@@ -0,0 +1,89 @@
+#pragma once
+
+#pragma region C++ Includes
+#include <string>
+#include <vector>
+#include <map>
+#include <mutex>
+#pragma endregion
+
+#pragma region SDL Includes
+#include "SDL.h"
+#pragma endregion
+
+#pragma region Engine Includes
+#include "ArchiveFormat.h"
+#pragma endregion
+
+using namespace std;
+
+/*
+ * Serves the files of the res/ directory from a single
+ * packed archive (see ArchiveFormat.h and the packer
+ * in tools/respack), when there's one.
+ * The archive is memory mapped: opening it is the
+ * only file system access, the OS pages contents in
+ * as they're read and files stored uncompressed are
+ * handed out as pointers into the mapping, with no
+ * copies. Compressed files are decompressed once, on
+ * first use, and kept until the archive is unmounted.
+ * Files are requested with the same paths used for
+ * loose files, anything not in the archive (or every
+ * file, when no archive is mounted) is read from the
+ * file system as before.
+ * Reading is thread safe, mounting is not: mount
+ * before loading anything and unmount after all the
+ * resources read from the archive have been freed.
+ */
+class ResourceArchive
+{
+	// Fields
+public:
+protected:
+private:
+	const Uint8 * data = nullptr;	//	The whole archive, mapped in memory
+	size_t size = 0;
+	const ArchiveEntry * entries = nullptr;
+	Uint32 entryCount = 0;
+	const char * names = nullptr;
+	string rootPath;	//	Path of the directory packed in the archive, ending with a separator
+#ifdef _WIN32
+	void * fileHandle = nullptr;
+	void * mappingHandle = nullptr;
+#endif
+	map<Uint32, vector<Uint8>> inflated;	//	Decompressed contents, by entry index
+	mutex inflatedMutex;
+	// Constructors
+public:
+	// Delete copy constructor and assignment operator (singleton protection)
+	ResourceArchive(const ResourceArchive &) = delete;
+	ResourceArchive & operator=(const ResourceArchive &) = delete;
+protected:
+private:
+	ResourceArchive() { }
+	// Methods
+public:
+	static ResourceArchive & Get()
+	{
+		//	Singleton implementation
+		static ResourceArchive instance;
+		return instance;
+	}
+	//	Maps the archive at archivePath as the contents of the directory at rootPath, returns false if it's missing or invalid
+	bool Mount(const string & archivePath, const string & rootPath);
+	void Unmount();
+	__inline bool IsMounted() const { return data != nullptr; }
+	__inline Uint32 GetEntryCount() const { return entryCount; }
+
+	//	Finds a file in the archive, data stays valid until unmounted (false if it's not in the archive)
+	bool Find(const string & path, const void * & fileData, size_t & fileSize);
+	//	Opens a file from the archive, or from the file system if it's not there (nullptr if it's nowhere)
+	SDL_RWops * Open(const string & path);
+protected:
+private:
+	//	Maps a file system path to the name of an entry (relative to the root, '/' separators)
+	string GetEntryName(const string & path) const;
+	//	Binary search over the sorted entries, -1 if not found
+	int FindEntry(const string & name) const;
+	void UnmapFile();
+};
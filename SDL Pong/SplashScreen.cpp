@@ -4,14 +4,11 @@
 #include <sstream>
 #pragma endregion
 
-#pragma region SDL Inlcudes
-#include "SDL_image.h"
-#pragma endregion
-
 #pragma region Engine Includes
 #include "Colors.h"
 #include "Input.h"
 #include "PathUtils.h"
+#include "RenderBatcher.h"
 #pragma endregion
 
 #pragma region Constant Parameters
@@ -39,15 +36,20 @@ bool SplashScreen::IsActive() const
 
 void SplashScreen::SetImage(const char * newImageFileName)
 {
+	FlushImage();
+
 	imagePath = PathUtils::Combine(
 		{
-			SDL_GetBasePath(),
+			PathUtils::GetBasePath(),
 			"res",
 			"img",
 			"splash",
 			PathUtils::AddImageExtension(newImageFileName)
 		}
 	);
+
+	//	Request the image right away, workers decode it while the game starts up
+	image = AssetManager::Get().LoadTexture(imagePath);
 }
 
 void SplashScreen::Update()
@@ -56,8 +58,8 @@ void SplashScreen::Update()
 		return;
 
 	if(
-		Input::Get().GetKey(SDLK_SPACE) ||
-		Input::Get().GetKey(SDLK_ESCAPE)
+		Input::Get().GetKey(SDL_SCANCODE_SPACE) ||
+		Input::Get().GetKey(SDL_SCANCODE_ESCAPE)
 		)
 		skip = true;
 }
@@ -69,6 +71,7 @@ const SDL_Color & SplashScreen::GetColor() const
 
 const SDL_Rect SplashScreen::GetRect() const
 {
+	const Vector2 textureSize = image ? image->GetTextureSize() : Vector2(0, 0);
 	SDL_Rect targetRect;
 	targetRect.h = (int)(viewport.h * SPLASH_VERTICAL_FILL);
 	targetRect.w = (int)(targetRect.h * (textureSize.x / (float)textureSize.y));
@@ -78,52 +81,23 @@ const SDL_Rect SplashScreen::GetRect() const
 	return targetRect;
 }
 
-void SplashScreen::PreRender(SDL_Renderer * r)
-{
-	if(
-		IsActive() &&
-		!imageTexture
-	)
-		LoadImage(r);
-}
-
 void SplashScreen::Render(SDL_Renderer * r) const
 {
+	//	Not loaded yet (or failed), skip it rather than waiting for it
+	SDL_Texture * imageTexture = image ? image->GetTexture() : nullptr;
+	if(!imageTexture)
+		return;
+
+	RenderBatcher::Get().Flush(r);
 	SDL_Rect targetRect = GetRect();
 	SDL_RenderCopy(r, imageTexture, nullptr, &targetRect);
 }
 
-void SplashScreen::LoadImage(SDL_Renderer * r)
-{
-	FlushImage();
-
-#ifdef LOAD_SPLASH_VIA_SURFACE
-		//	Load image file into a surface with pixel-level access
-	SDL_Surface * splashImageSurface = IMG_Load(imagePath.c_str());
-	if(splashImageSurface)
-	{
-		//	Create a texture and store texture size information
-		splashImageTexture = SDL_CreateTextureFromSurface(r, splashImageSurface);
-		// //	in this case it's faster to just read teh surface's type instead of querying the texture
-		textureSize.x = splashImageSurface->w;
-		textureSize.y = splashImageSurface->h;
-		//	Free the surface
-		SDL_FreeSurface(splashImageSurface);
-	}
-#else
-		//	Load image file directly into a texture
-	imageTexture = IMG_LoadTexture(r, imagePath.c_str());
-	//	Query the texture for the relevant information (size, we omit format and access, which we don't need now)
-	if(imageTexture)
-		SDL_QueryTexture(imageTexture, nullptr, nullptr, &textureSize.x, &textureSize.y);
-#endif
-}
-
 void SplashScreen::FlushImage()
 {
-	if(!imageTexture)
+	if(!image)
 		return;
 
-	SDL_DestroyTexture(imageTexture);
-	imageTexture = nullptr;
+	AssetManager::Get().Release(image);
+	image = nullptr;
 }
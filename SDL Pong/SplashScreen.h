@@ -11,6 +11,7 @@
 #pragma region Engine Includes
 #include "IUpdatable.h"
 #include "IRenderable.h"
+#include "AssetManager.h"
 #pragma endregion
 
 using namespace std;
@@ -26,8 +27,7 @@ private:
 	const Uint64 startTime;
 	const Uint32 duration;
 	string imagePath;
-	SDL_Texture * imageTexture = nullptr;
-	Vector2 textureSize{0, 0};
+	Asset * image = nullptr;	//	Loaded in the background, nothing is drawn until it's ready
 	bool skip = false;
 	// Constructors
 public:
@@ -46,11 +46,9 @@ public:
 	//	IRenderable implementation
 	const SDL_Color & GetColor() const override;
 	const SDL_Rect GetRect() const override;
-	void PreRender(SDL_Renderer * r) override;
 	void Render(SDL_Renderer * r) const override;
 protected:
 private:
-	void LoadImage(SDL_Renderer * r);
 	void FlushImage();
 };
 
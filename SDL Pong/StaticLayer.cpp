@@ -0,0 +1,122 @@
+#include "StaticLayer.h"
+
+#pragma region C++ Includes
+#include <iostream>
+#pragma endregion
+
+#pragma region Engine Includes
+#include "Colors.h"
+#include "RenderBatcher.h"
+#include "DirtyRects.h"
+#pragma endregion
+
+Uint32 StaticLayer::generation = 0;
+
+StaticLayer::StaticLayer(int width, int height, initializer_list<IRenderable *> staticRenderables) :
+	renderables(staticRenderables),
+	rect{0, 0, width, height},
+	color(SDLC_CLEAR)	//	Unused
+{ }
+
+StaticLayer::~StaticLayer()
+{
+	if(texture)
+		SDL_DestroyTexture(texture);
+	texture = nullptr;
+}
+
+void StaticLayer::SetSize(int width, int height)
+{
+	if(width == rect.w && height == rect.h)
+		return;
+
+	rect.w = width;
+	rect.h = height;
+	Invalidate();
+}
+
+void StaticLayer::PreRender(SDL_Renderer * r)
+{
+	//	Renderables still get their pre-render, as if they weren't in the layer
+	for(IRenderable * const & renderable : renderables)
+		renderable->PreRender(r);
+
+	if(!dirty && bakedGeneration == generation)
+		return;
+
+	if(!Bake(r) && texture)
+	{
+		//	Draw directly from now on
+		SDL_DestroyTexture(texture);
+		texture = nullptr;
+	}
+	dirty = false;
+	bakedGeneration = generation;
+
+	//	What the layer shows may have changed anywhere
+	DirtyRects::Get().Invalidate(rect);
+}
+
+void StaticLayer::Render(SDL_Renderer * r) const
+{
+	//	No texture to copy, draw the renderables directly
+	if(!texture)
+	{
+		for(const IRenderable * const & renderable : renderables)
+			renderable->Render(r);
+		return;
+	}
+
+	RenderBatcher::Get().Flush(r);
+	SDL_RenderCopy(r, texture, nullptr, &rect);
+}
+
+bool StaticLayer::Bake(SDL_Renderer * r)
+{
+	if(!SDL_RenderTargetSupported(r) || rect.w <= 0 || rect.h <= 0)
+		return false;
+
+	//	A texture of a different size can't be reused
+	if(texture)
+	{
+		int textureWidth = 0, textureHeight = 0;
+		SDL_QueryTexture(texture, nullptr, nullptr, &textureWidth, &textureHeight);
+		if(textureWidth != rect.w || textureHeight != rect.h)
+		{
+			SDL_DestroyTexture(texture);
+			texture = nullptr;
+		}
+	}
+	if(!texture)
+	{
+		texture = SDL_CreateTexture(r, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_TARGET, rect.w, rect.h);
+		if(!texture)
+		{
+			cout << "Couldn't create static layer texture: " << SDL_GetError() << endl;
+			return false;
+		}
+		SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
+	}
+
+	//	Anything still queued belongs to the current target, not to the layer
+	RenderBatcher & batcher = RenderBatcher::Get();
+	batcher.Flush(r);
+
+	SDL_Texture * const previousTarget = SDL_GetRenderTarget(r);
+	if(SDL_SetRenderTarget(r, texture) != 0)
+	{
+		cout << "Couldn't draw on static layer texture: " << SDL_GetError() << endl;
+		return false;
+	}
+
+	//	Transparent where nothing is drawn
+	SDL_SetRenderDrawColor(r, 0, 0, 0, 0);
+	SDL_SetRenderDrawBlendMode(r, SDL_BLENDMODE_NONE);
+	SDL_RenderClear(r);
+	for(const IRenderable * const & renderable : renderables)
+		renderable->Render(r);
+	batcher.Flush(r);
+
+	SDL_SetRenderTarget(r, previousTarget);
+	return true;
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+#pragma region C++ Includes
+#include <vector>
+#include <initializer_list>
+#pragma endregion
+
+#pragma region SDL Includes
+#include "SDL.h"
+#pragma endregion
+
+#pragma region Engine Includes
+#include "IRenderable.h"
+#pragma endregion
+
+using namespace std;
+
+/*
+ * Renderables that never change (e.g. the borders of
+ * the field) drawn once on a texture, which is then
+ * drawn with a single copy each frame instead of
+ * drawing them one by one.
+ * The layer covers the viewport from its top left
+ * corner, transparent where nothing is drawn, so what
+ * it holds ends up behind whatever is drawn after it.
+ * It's baked on the first pre-render and baked again
+ * when invalidated: when its size changes, on request
+ * or when the renderer loses the content of its
+ * target textures (see InvalidateAll()).
+ * Renderers that can't draw on textures draw the
+ * renderables directly, as if there was no layer.
+ */
+class StaticLayer : public IRenderable
+{
+	// Fields
+public:
+protected:
+private:
+	const vector<IRenderable *> renderables;	//	Drawn in this order
+	SDL_Rect rect;
+	const SDL_Color color;	//	Unused
+	SDL_Texture * texture = nullptr;
+	bool dirty = true;	//	When true, the layer is baked on the next pre-render
+	Uint32 bakedGeneration = 0;
+
+	static Uint32 generation;	//	Bumped to invalidate all layers
+	// Constructors
+public:
+	StaticLayer(int width, int height, initializer_list<IRenderable *> staticRenderables);
+	// Delete copy constructor and assignment operator (layers own their texture)
+	StaticLayer(const StaticLayer &) = delete;
+	StaticLayer & operator=(const StaticLayer &) = delete;
+	~StaticLayer();
+protected:
+private:
+	// Methods
+public:
+	void SetSize(int width, int height);
+	//	Bakes the layer again on the next pre-render, e.g. after changing any of its renderables
+	__inline void Invalidate() { dirty = true; }
+	//	Bakes all layers again, call when the renderer loses the content of target textures
+	__inline static void InvalidateAll() { generation++; }
+
+	//	IRenderable implementation
+	const SDL_Color & GetColor() const override { return color; }
+	const SDL_Rect GetRect() const override { return rect; }
+	void PreRender(SDL_Renderer * r) override;
+	void Render(SDL_Renderer * r) const override;
+protected:
+private:
+	//	Draws the renderables on the texture (creating it if needed), returns false if that's not possible
+	bool Bake(SDL_Renderer * r);
+};
@@ -0,0 +1,39 @@
+#pragma once
+
+#pragma region C++ Includes
+#include <cstdint>
+#pragma endregion
+
+/*
+ * Layout of a pre-decoded texture (.tex), shared by
+ * the game and the converter tool (so only standard
+ * types).
+ * A header followed by the pixels, rows top to bottom,
+ * in a pixel format the renderer can take as it is:
+ * loading one is a copy (or an LZ4 decompression)
+ * and an upload, with no image decoder involved.
+ * Numbers are little endian, as in the archive.
+ */
+
+#define TEXTURE_FILE_MAGIC "STEX"
+#define TEXTURE_FILE_MAGIC_SIZE 4
+#define TEXTURE_FILE_VERSION 1
+#define TEXTURE_FILE_EXTENSION "tex"
+
+typedef enum
+{
+	TC_None	= 0,	//	Raw pixels, uploaded in place
+	TC_Lz4	= 1		//	LZ4 block, decompressed before the upload
+} TextureCompression;
+
+typedef struct
+{
+	char magic[TEXTURE_FILE_MAGIC_SIZE];
+	uint32_t version;
+	uint32_t width;
+	uint32_t height;
+	uint32_t pixelFormat;	//	An SDL_PixelFormatEnum value, 4 bytes per pixel
+	uint32_t pitch;	//	Bytes per row
+	uint32_t compression;	//	TextureCompression
+	uint32_t dataSize;	//	Bytes of pixel data following the header, as stored
+} TextureFileHeader;
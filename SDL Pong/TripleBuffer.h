@@ -0,0 +1,68 @@
+#pragma once
+
+#pragma region C++ Includes
+#include <atomic>
+#pragma endregion
+
+using namespace std;
+
+/*
+ * Hands values over from a thread producing them to
+ * a thread consuming them, with no locks and no
+ * waiting on either side.
+ * There are three slots: the writer fills its own
+ * (back) and publishes it by swapping it with the
+ * middle one, the reader takes the middle one, when
+ * something new was published there, by swapping
+ * it with its own (front). Each side always owns a
+ * slot nobody else touches, so the writer never
+ * waits for the reader to finish and vice versa; a
+ * slow reader simply skips the values it missed and
+ * always gets the latest one.
+ * Slots are reused, so values holding containers
+ * keep their memory across publications.
+ */
+template<typename T>
+class TripleBuffer
+{
+	// Fields
+public:
+protected:
+private:
+	static const int indexMask = 3;
+	static const int freshBit = 4;	//	Set in middle when it holds a value the reader hasn't taken yet
+
+	T slots[3];
+	int back = 0;	//	Writer's slot
+	atomic<int> middle{1};
+	int front = 2;	//	Reader's slot
+	// Constructors
+public:
+	TripleBuffer() { }
+	// Delete copy constructor and assignment operator (threads refer to the slots)
+	TripleBuffer(const TripleBuffer &) = delete;
+	TripleBuffer & operator=(const TripleBuffer &) = delete;
+protected:
+private:
+	// Methods
+public:
+	//	Writer side: the slot to fill, then Publish() it
+	__inline T & GetBack() { return slots[back]; }
+	void Publish()
+	{
+		back = middle.exchange(back | freshBit, memory_order_acq_rel) & indexMask;
+	}
+
+	//	Reader side: takes the latest value published, if any since the last call (returns false otherwise)
+	bool Acquire()
+	{
+		if(!(middle.load(memory_order_relaxed) & freshBit))
+			return false;
+		front = middle.exchange(front, memory_order_acq_rel) & indexMask;
+		return true;
+	}
+	//	The latest value acquired
+	__inline const T & GetFront() const { return slots[front]; }
+protected:
+private:
+};
@@ -0,0 +1,135 @@
+#include "WorkerPool.h"
+
+WorkerPool::WorkerPool(int workerCount)
+{
+#ifndef __EMSCRIPTEN__
+	//	Default to one worker per core (hardware_concurrency() can return 0 when it can't tell)
+	if(workerCount <= 0)
+		workerCount = (int)thread::hardware_concurrency();
+	if(workerCount <= 0)
+		workerCount = 1;
+
+	workers.reserve(workerCount);
+	for(int i = 0; i < workerCount; i++)
+		workers.emplace_back(&WorkerPool::WorkerLoop, this);
+#endif
+}
+
+WorkerPool::~WorkerPool()
+{
+#ifndef __EMSCRIPTEN__
+	//	Wake up all workers and let them quit once the queue is drained
+	{
+		lock_guard<mutex> lock(jobsMutex);
+		stopping = true;
+	}
+	jobsAvailable.notify_all();
+
+	for(thread & worker : workers)
+		worker.join();
+#endif
+}
+
+int WorkerPool::GetWorkerCount() const
+{
+#ifndef __EMSCRIPTEN__
+	return (int)workers.size();
+#else
+	return 0;
+#endif
+}
+
+void WorkerPool::Enqueue(function<void()> job)
+{
+#ifndef __EMSCRIPTEN__
+	{
+		lock_guard<mutex> lock(jobsMutex);
+		jobs.push(move(job));
+	}
+	jobsAvailable.notify_one();
+#else
+	//	No threads, no queue: just run the job
+	job();
+#endif
+}
+
+void WorkerPool::ParallelFor(int count, const function<void(int first, int last)> & body)
+{
+	if(count <= 0)
+		return;
+
+#ifndef __EMSCRIPTEN__
+	/*
+	 * The range is split in one contiguous shard per
+	 * worker, plus one for the calling thread which
+	 * would otherwise just sit and wait.
+	 * Contiguous shards keep each thread on its own
+	 * portion of memory, so threads don't contend
+	 * for the same cache lines.
+	 * Completion is tracked per call (not per pool)
+	 * so that unrelated jobs in the queue don't delay
+	 * the return of this function.
+	 */
+	int shards = GetWorkerCount() + 1;
+	if(shards > count)
+		shards = count;
+	const int shardSize = count / shards;
+	const int shardRemainder = count % shards;
+
+	mutex doneMutex;
+	condition_variable doneSignal;
+	int pendingShards = shards - 1;
+
+	int first = 0;
+	for(int shard = 0; shard < shards; shard++)
+	{
+		//	Spread the remainder over the first shards
+		const int last = first + shardSize + (shard < shardRemainder ? 1 : 0);
+
+		//	The last shard is processed by the calling thread
+		if(shard == shards - 1)
+			body(first, last);
+		else
+			Enqueue(
+				[&body, &doneMutex, &doneSignal, &pendingShards, first, last]()
+				{
+					body(first, last);
+
+					lock_guard<mutex> lock(doneMutex);
+					if(--pendingShards == 0)
+						doneSignal.notify_one();
+				}
+			);
+
+		first = last;
+	}
+
+	//	Wait for the shards processed by the workers
+	unique_lock<mutex> lock(doneMutex);
+	doneSignal.wait(lock, [&pendingShards]() { return pendingShards == 0; });
+#else
+	body(0, count);
+#endif
+}
+
+#ifndef __EMSCRIPTEN__
+void WorkerPool::WorkerLoop()
+{
+	while(true)
+	{
+		function<void()> job;
+
+		//	Wait for a job (or for the pool to stop)
+		{
+			unique_lock<mutex> lock(jobsMutex);
+			jobsAvailable.wait(lock, [this]() { return stopping || !jobs.empty(); });
+			if(jobs.empty())
+				return;
+			job = move(jobs.front());
+			jobs.pop();
+		}
+
+		job();
+	}
+}
+#endif
@@ -0,0 +1,63 @@
+#pragma once
+
+#pragma region C++ Includes
+#include <vector>
+#include <queue>
+#include <functional>
+#ifndef __EMSCRIPTEN__
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#endif
+#pragma endregion
+
+using namespace std;
+
+/*
+ * A pool of worker threads consuming a shared queue
+ * of jobs.
+ * Jobs can be fired and forgotten with Enqueue() or
+ * a range of work can be split across all workers
+ * with ParallelFor(), which returns only when the
+ * whole range has been processed.
+ *
+ * When targetting webgl there are no threads, so
+ * the pool has no workers and all jobs run inline,
+ * on the calling thread.
+ */
+class WorkerPool
+{
+	// Fields
+public:
+protected:
+private:
+#ifndef __EMSCRIPTEN__
+	vector<thread> workers;
+	queue<function<void()>> jobs;
+	mutex jobsMutex;
+	condition_variable jobsAvailable;
+	bool stopping = false;
+#endif
+	// Constructors
+public:
+	//	A worker count of 0 (default) creates a worker for each core
+	WorkerPool(int workerCount = 0);
+	~WorkerPool();
+	// Delete copy constructor and assignment operator (threads can't be shared)
+	WorkerPool(const WorkerPool &) = delete;
+	WorkerPool & operator=(const WorkerPool &) = delete;
+protected:
+private:
+	// Methods
+public:
+	int GetWorkerCount() const;
+	//	Schedules a job to be run by the first available worker
+	void Enqueue(function<void()> job);
+	//	Splits [0, count) in contiguous shards and processes them in parallel, the calling thread takes a shard too
+	void ParallelFor(int count, const function<void(int first, int last)> & body);
+protected:
+private:
+#ifndef __EMSCRIPTEN__
+	void WorkerLoop();
+#endif
+};
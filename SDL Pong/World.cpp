@@ -0,0 +1,181 @@
+#include "World.h"
+
+#pragma region C++ Includes
+#include <cmath>
+#pragma endregion
+
+#pragma region Engine Includes
+#include "Colors.h"
+#include "Collision.h"
+#pragma endregion
+
+BodyId World::Add(int width, int height, Fixed bodySpeed)
+{
+	const BodyId id = GetCount();
+
+	//	Transform (default pivot is the center of the body)
+	positionX.push_back(0);
+	positionY.push_back(0);
+	previousX.push_back(0);
+	previousY.push_back(0);
+	scale.push_back(FIXED_ONE);
+	pivotX.push_back(FIXED_HALF);
+	pivotY.push_back(FIXED_HALF);
+	//	Presence
+	sizeW.push_back(width);
+	sizeH.push_back(height);
+	//	Movement
+	velocityX.push_back(0);
+	velocityY.push_back(0);
+	speed.push_back(bodySpeed);
+	//	Appearance
+	color.push_back(SDLC_WHITE);
+	//	Cached rect, computed on first use
+	rectX.push_back(0);
+	rectY.push_back(0);
+	rectW.push_back(0);
+	rectH.push_back(0);
+	rectDirty.push_back(0);
+	Invalidate(id);
+
+	return id;
+}
+
+const SDL_Rect World::GetRect(BodyId id) const
+{
+	if(rectDirty[id])
+		ComputeRect(id);
+
+	return SDL_Rect{rectX[id], rectY[id], rectW[id], rectH[id]};
+}
+
+const FixedRect World::GetFixedRect(BodyId id) const
+{
+	//	Same math as ComputeRect(), without rounding the position
+	const Fixed width = FixedFromInt(GetScaledWidth(id));
+	const Fixed height = FixedFromInt(GetScaledHeight(id));
+	return FixedRect{positionX[id] - FixedMul(width, pivotX[id]), positionY[id] - FixedMul(height, pivotY[id]), width, height};
+}
+
+void World::RefreshRects() const
+{
+	if(!anyRectDirty)
+		return;
+
+	const int count = GetCount();
+	for(BodyId id = 0; id < count; id++)
+		if(rectDirty[id])
+			ComputeRect(id);
+
+	anyRectDirty = false;
+}
+
+void World::BeginTick()
+{
+	previousX = positionX;
+	previousY = positionY;
+}
+
+void World::CaptureRenderState(WorldRenderState & state) const
+{
+	RefreshRects();
+
+	const int count = GetCount();
+	state.rects.resize(count);
+	state.shifts.resize(count);
+	state.colors.resize(count);
+	for(BodyId id = 0; id < count; id++)
+	{
+		state.rects[id] = SDL_Rect{rectX[id], rectY[id], rectW[id], rectH[id]};
+		state.shifts[id] = SDL_Point{previousX[id] - positionX[id], previousY[id] - positionY[id]};
+		state.colors[id] = color[id];
+	}
+}
+
+const SDL_Rect World::GetRenderRect(BodyId id) const
+{
+	SDL_Rect rect;
+	SDL_Point shift;
+	if(renderState)
+	{
+		rect = renderState->rects[id];
+		shift = renderState->shifts[id];
+	}
+	else
+	{
+		rect = GetRect(id);
+		shift = SDL_Point{previousX[id] - positionX[id], previousY[id] - positionY[id]};
+	}
+
+	/*
+	 * The cached rect is at the current position, it's
+	 * shifted back towards the previous position by the
+	 * part of the tick that hasn't been rendered yet.
+	 */
+	if(renderAlpha < 1.0f)
+	{
+		rect.x += (int)lroundf(FixedToFloat(shift.x) * (1.0f - renderAlpha));
+		rect.y += (int)lroundf(FixedToFloat(shift.y) * (1.0f - renderAlpha));
+	}
+
+	return rect;
+}
+
+int World::QueryOverlaps(const SDL_Rect & rect, vector<Uint32> & hitMask) const
+{
+	const int count = GetCount();
+	hitMask.resize(COLLISION_MASK_WORDS(count));
+	if(count == 0)
+		return 0;
+
+	//	The test reads the cached rects directly, make sure they're all up to date
+	RefreshRects();
+
+	return Collision::OverlapMask(rect, rectX.data(), rectY.data(), rectW.data(), rectH.data(), count, hitMask.data());
+}
+
+int World::QueryOverlaps(const FixedRect & rect, vector<Uint32> & hitMask) const
+{
+	//	Broad phase on pixels, then only the bodies whose exact rects overlap are kept
+	int hits = QueryOverlaps(Collision::CoveringPixels(rect), hitMask);
+	const int words = (int)hitMask.size();
+	for(
+		int body = Collision::FirstCommonBit(hitMask.data(), words, hitMask.data(), words);
+		body >= 0;
+		body = Collision::NextCommonBit(hitMask.data(), words, hitMask.data(), words, body + 1)
+		)
+		if(!Collision::Overlaps(rect, GetFixedRect(body)))
+		{
+			Collision::ClearBit(hitMask.data(), body);
+			hits--;
+		}
+
+	return hits;
+}
+
+void World::ComputeRect(BodyId id) const
+{
+	/*
+	 * Calculate the final rect in SDL-space based on
+	 * size and pivot.
+	 * SDL space has (0, 0) coordinates in the top-left
+	 * corner of the render target. When drawing a rect,
+	 * (x, y) refer to the rect's top-left corner's distance
+	 * from the top-left corner of the render target,
+	 * which isn't always the most handy situation.
+	 * This function calculates the actual extents of the
+	 * rect, taking into account size and scale, and
+	 * offsets it by the pivot value, proportionally.
+	 * Everything is in fixed point, the position is only
+	 * rounded down to the pixel at the very end.
+	 */
+
+	//	Calculate actual extents
+	rectW[id] = GetScaledWidth(id);
+	rectH[id] = GetScaledHeight(id);
+	//	Offset by pivot, proportionally
+	rectX[id] = FixedFloor(positionX[id] - FixedMul(FixedFromInt(rectW[id]), pivotX[id]));
+	rectY[id] = FixedFloor(positionY[id] - FixedMul(FixedFromInt(rectH[id]), pivotY[id]));
+
+	rectDirty[id] = 0;
+}
@@ -0,0 +1,197 @@
+#pragma once
+
+#pragma region C++ Includes
+#include <vector>
+#pragma endregion
+
+#pragma region SDL Includes
+#include "SDL.h"
+#pragma endregion
+
+#pragma region Engine Includes
+#include "Types.h"
+#include "Fixed.h"
+#pragma endregion
+
+using namespace std;
+
+//	Identifies a body in its world (it's the index of the body in all the world's arrays)
+typedef int BodyId;
+#define NO_BODY -1
+
+//	What rendering needs to know about the bodies of a world, copied at the end of a tick (indexed by body id)
+typedef struct
+{
+	vector<SDL_Rect> rects;
+	vector<SDL_Point> shifts;	//	From the current position back to the previous one, in fixed point
+	vector<SDL_Color> colors;
+} WorldRenderState;
+
+//	What changes of a body while it's simulated, plain data that can be saved and restored (see World::SaveBody())
+typedef struct
+{
+	Fixed x;
+	Fixed y;
+	Fixed previousX;
+	Fixed previousY;
+	Fixed velocityX;
+	Fixed velocityY;
+} BodySnapshot;
+
+/*
+ * Storage for the state of all the bodies of a
+ * scene, laid out as a structure of arrays: each
+ * property has its own contiguous array, indexed
+ * by body id.
+ * Systems that process many bodies at once (e.g.
+ * collision checks or rendering) walk linear memory
+ * and only touch the properties they need.
+ *
+ * Transforms and movement are in fixed point (see
+ * Fixed.h), so bodies move by fractions of a pixel and
+ * the simulation is bit-identical on every machine;
+ * sizes are whole pixels. A body covers the pixels of
+ * its exact rect rounded down (see GetFixedRect()).
+ *
+ * World-space rects are cached and recomputed only
+ * when a property affecting them changes (position,
+ * size, scale or pivot).
+ *
+ * The world also remembers where bodies were at the
+ * beginning of the current simulation tick, so that
+ * rendering can interpolate between the last two
+ * simulated states when it runs at a different rate
+ * than the simulation.
+ * When rendering runs on its own thread, it doesn't
+ * read the bodies while they're simulated: it reads
+ * a copy of their rects and colors taken at the end
+ * of a tick (see CaptureRenderState()).
+ */
+class World
+{
+	// Fields
+public:
+protected:
+private:
+	//	Transform
+	vector<Fixed> positionX;
+	vector<Fixed> positionY;
+	vector<Fixed> previousX;	//	Position at the beginning of the current tick
+	vector<Fixed> previousY;	//	Position at the beginning of the current tick
+	vector<Fixed> scale;
+	vector<Fixed> pivotX;
+	vector<Fixed> pivotY;
+	//	Presence
+	vector<int> sizeW;
+	vector<int> sizeH;
+	//	Movement (per tick)
+	vector<Fixed> velocityX;
+	vector<Fixed> velocityY;
+	vector<Fixed> speed;
+	//	Appearance
+	vector<SDL_Color> color;
+	//	Cached world-space rects, in pixels
+	mutable vector<int> rectX;
+	mutable vector<int> rectY;
+	mutable vector<int> rectW;
+	mutable vector<int> rectH;
+	mutable vector<Uint8> rectDirty;
+	mutable bool anyRectDirty = false;
+	//	Interpolation factor between previous and current positions used by render rects
+	float renderAlpha = 1.0f;
+	//	State render rects and colors are read from, the live state when not set
+	const WorldRenderState * renderState = nullptr;
+	// Constructors
+public:
+	World() { }
+	// Delete copy constructor and assignment operator (bodies refer to their world)
+	World(const World &) = delete;
+	World & operator=(const World &) = delete;
+protected:
+private:
+	// Methods
+public:
+	//	Adds a body to the world with default transform and color, returns its id (speed in pixels per tick, fixed point)
+	BodyId Add(int width, int height, Fixed bodySpeed = 0);
+	__inline int GetCount() const { return (int)positionX.size(); }
+
+	//	Transform
+	__inline FixedVector2 GetPosition(BodyId id) const { return FixedVector2(positionX[id], positionY[id]); }
+	__inline void SetPosition(BodyId id, Fixed x, Fixed y) { positionX[id] = x; positionY[id] = y; Invalidate(id); }
+	__inline void Translate(BodyId id, Fixed dx, Fixed dy) { positionX[id] += dx; positionY[id] += dy; Invalidate(id); }
+	//	Like SetPosition() but also moves the previous position, so the body jumps there with no interpolation
+	__inline void Teleport(BodyId id, Fixed x, Fixed y) { SetPosition(id, x, y); previousX[id] = x; previousY[id] = y; }
+	__inline Fixed GetScale(BodyId id) const { return scale[id]; }
+	__inline void SetScale(BodyId id, Fixed newScale) { scale[id] = newScale; Invalidate(id); }
+	__inline FixedVector2 GetPivot(BodyId id) const { return FixedVector2(pivotX[id], pivotY[id]); }
+	__inline void SetPivot(BodyId id, Fixed x, Fixed y) { pivotX[id] = x; pivotY[id] = y; Invalidate(id); }
+
+	//	Presence
+	__inline Vector2 GetSize(BodyId id) const { return Vector2(sizeW[id], sizeH[id]); }
+	__inline void SetSize(BodyId id, int width, int height) { sizeW[id] = width; sizeH[id] = height; Invalidate(id); }
+
+	//	Movement
+	__inline FixedVector2 GetVelocity(BodyId id) const { return FixedVector2(velocityX[id], velocityY[id]); }
+	__inline void SetVelocity(BodyId id, Fixed x, Fixed y) { velocityX[id] = x; velocityY[id] = y; }
+	__inline Fixed GetSpeed(BodyId id) const { return speed[id]; }
+	__inline void SetSpeed(BodyId id, Fixed newSpeed) { speed[id] = newSpeed; }
+
+	//	Snapshots (size, scale, pivot, speed and color are set up once, they're not part of it)
+	__inline void SaveBody(BodyId id, BodySnapshot & snapshot) const
+	{
+		snapshot.x = positionX[id];
+		snapshot.y = positionY[id];
+		snapshot.previousX = previousX[id];
+		snapshot.previousY = previousY[id];
+		snapshot.velocityX = velocityX[id];
+		snapshot.velocityY = velocityY[id];
+	}
+	__inline void RestoreBody(BodyId id, const BodySnapshot & snapshot)
+	{
+		positionX[id] = snapshot.x;
+		positionY[id] = snapshot.y;
+		previousX[id] = snapshot.previousX;
+		previousY[id] = snapshot.previousY;
+		velocityX[id] = snapshot.velocityX;
+		velocityY[id] = snapshot.velocityY;
+		Invalidate(id);
+	}
+
+	//	Appearance
+	__inline const SDL_Color & GetColor(BodyId id) const { return color[id]; }
+	__inline void SetColor(BodyId id, const SDL_Color & newColor) { color[id] = newColor; }
+
+	//	World-space rects
+	const SDL_Rect GetRect(BodyId id) const;
+	//	Exact world-space rect, with the position of the rect in pixels rounded down it's the one returned by GetRect()
+	const FixedRect GetFixedRect(BodyId id) const;
+	//	Brings all cached rects up to date in a single pass
+	void RefreshRects() const;
+	//	Raw access to the cached rects (call RefreshRects() first), useful to process many rects at once
+	__inline const int * GetRectsX() const { return rectX.data(); }
+	__inline const int * GetRectsY() const { return rectY.data(); }
+	__inline const int * GetRectsW() const { return rectW.data(); }
+	__inline const int * GetRectsH() const { return rectH.data(); }
+	//	Stores current positions as previous positions, call at the beginning of each simulation tick
+	void BeginTick();
+	//	Copies what rendering needs, reusing the memory of the state
+	void CaptureRenderState(WorldRenderState & state) const;
+	//	Makes render rects and colors come from a captured state (nullptr for the live one), it must outlive its use
+	__inline void SetRenderState(const WorldRenderState * state) { renderState = state; }
+	//	Sets how far render rects are between the previous and the current positions (0 = previous, 1 = current)
+	__inline void SetRenderAlpha(float alpha) { renderAlpha = alpha; }
+	//	World-space rect of a body to render, interpolated based on the render alpha
+	const SDL_Rect GetRenderRect(BodyId id) const;
+	//	Color of a body to render
+	__inline const SDL_Color & GetRenderColor(BodyId id) const { return renderState ? renderState->colors[id] : color[id]; }
+	//	Tests rect against all the bodies of the world at once (see Collision::OverlapMask()), hitMask is resized as needed, bits are indexed by body id
+	int QueryOverlaps(const SDL_Rect & rect, vector<Uint32> & hitMask) const;
+	//	Same as above, against the exact rects of the bodies
+	int QueryOverlaps(const FixedRect & rect, vector<Uint32> & hitMask) const;
+protected:
+private:
+	__inline void Invalidate(BodyId id) { rectDirty[id] = 1; anyRectDirty = true; }
+	void ComputeRect(BodyId id) const;
+	__inline int GetScaledWidth(BodyId id) const { return FixedFloor(FixedMul(FixedFromInt(sizeW[id]), scale[id])); }
+	__inline int GetScaledHeight(BodyId id) const { return FixedFloor(FixedMul(FixedFromInt(sizeH[id]), scale[id])); }
+};
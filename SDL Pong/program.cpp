@@ -6,6 +6,14 @@
 #include <string>
 #include <vector>
 #include <map>
+#include <cstdlib>
+#include <cctype>
+#include <cstring>
+#include <atomic>
+#include <random>
+#ifndef __EMSCRIPTEN__
+#include <thread>
+#endif
 #pragma endregion
 
 #pragma region SDL Includes
@@ -24,15 +32,29 @@
 #include "IRenderable.h"	//	Interface used in the render loop
 #include "Input.h"	//	Singleton that manages and exposes input events
 #include "PathUtils.h"	//	Utilities for cross-platform paths handing
+#include "WorkerPool.h"	//	Pool of threads to split work across cores
+#include "FramePacer.h"	//	Keeps a steady frame rate
+#include "FrameProfiler.h"	//	Measures the stages of each frame
+#include "GlyphAtlas.h"	//	Shared textures with the glyphs of fonts
+#include "FontCache.h"	//	Keeps fonts open across uses
+#include "AssetManager.h"	//	Loads assets in the background
+#include "ResourceArchive.h"	//	Serves resources from a packed archive
+#include "RenderBatcher.h"	//	Draws filled rects with few draw calls
+#include "DirtyRects.h"	//	Tracks the regions of the screen to draw again
+#include "StaticLayer.h"	//	Draws static renderables once on a texture
+#include "ReplayRecorder.h"	//	Records the inputs of a match
+#include "ReplayPlayer.h"	//	Plays recorded inputs back
 #pragma endregion
 
 #pragma region Game Includes
 //	Game elements
 #include "PongGame.h"
+#include "PongRules.h"
 
 #include "Paddle.h"
 #include "Ball.h"
 #include "Label.h"
+#include "BatchSimulator.h"
 #pragma endregion
 
 #pragma region Emscripten Includes
@@ -72,7 +94,7 @@ using namespace std::chrono;
 #define VIEWPORT_W 800
 #define VIEWPORT_H 450
 #define VIEWPORT_MODE SDL_WINDOW_RESIZABLE
-#elif
+#else
 #define VIEWPORT_W 1920
 #define VIEWPORT_H 1080
 #define VIEWPORT_MODE SDL_WINDOW_FULLSCREEN
@@ -108,9 +130,21 @@ using namespace std::chrono;
 #define MIX_INIT_MODE MIX_INIT_MP3
 #endif
 
-//	The fixed time step we aim to
+/*
+ * The simulation advances in fixed time steps (ticks)
+ * at its own rate, while frames are rendered at the
+ * display's rate (or at the target frame rate below,
+ * when the display's one is unknown).
+ * When rendering falls behind, the simulation catches
+ * up with more ticks per frame, but never more than
+ * the maximum, and long stalls (e.g. a dragged window)
+ * are counted as the maximum frame time, so the game
+ * slows down instead of freezing to catch up.
+ */
 #define TARGET_FPS 60
-#define TARGET_FRAME_TIME 1000 / TARGET_FPS
+#define DEFAULT_TICK_RATE RULES_TICK_RATE
+#define MAX_TICKS_PER_FRAME 8
+#define MAX_FRAME_TIME_NS 250000000LL
 
 #define RENDER_CLEAR_COLOR 10, 10, 10, 255
 
@@ -124,6 +158,32 @@ using namespace std::chrono;
 #ifdef __EMSCRIPTEN__
 #define HTML_CANVAS_SELECTOR "#canvas"
 #endif
+
+/*
+ * Headless runs simulate the game with no window,
+ * renderer or audio device. The field size is fixed
+ * so that simulations don't depend on the machine
+ * they run on.
+ */
+#ifndef __EMSCRIPTEN__
+#define HEADLESS_ARG "--headless"
+#define HEADLESS_VIEWPORT_W 1920
+#define HEADLESS_VIEWPORT_H 1080
+#define HEADLESS_DEFAULT_FRAMES 36000	//	10 minutes of gameplay at the default tick rate
+#define TICK_RATE_ARG "--tick-rate"
+#define TRACE_ARG "--trace"
+#define SINGLE_THREAD_ARG "--single-thread"
+#define SEED_ARG "--seed"
+#define RECORD_ARG "--record"
+#define REPLAY_ARG "--replay"
+#define BATCH_ARG "--batch"
+#define BATCH_DEFAULT_MATCHES 1024
+#define BATCH_SEED 0
+#define SNAPSHOT_BENCH_ARG "--snapshot-bench"
+#define SNAPSHOT_BENCH_DEFAULT_ROUNDS 1000000
+#define SNAPSHOT_BENCH_SLOTS 64	//	Power of 2, snapshots cycled through so that every save and restore really happens
+#define SNAPSHOT_BENCH_ROLLBACK_FRAMES 600	//	Ticks simulated again after restoring, to check the rollback
+#endif
 #pragma endregion
 
 #pragma region Exchange data
@@ -133,18 +193,44 @@ typedef struct
 	SDL_Renderer * r;
 	int viewportWidth;
 	int viewportHeight;
+	int refreshRate;	//	Frames per second rendered
+	bool headless;
 
 } SystemData;
 typedef struct
 {
-	bool closeRequested;
+	atomic<bool> closeRequested;	//	Set by the simulation, read by the render thread too
+	atomic<bool> simulationStopped;	//	Set once the simulation loop is over, the render thread disposes the game after it
+	bool threadedRendering;	//	When true, frames are rendered on their own thread while the main thread simulates
+#ifndef __EMSCRIPTEN__
+	thread renderThread;
+#endif
+	atomic<bool> fullRedrawRequested;	//	Set by window events, the next frame is drawn in full
+	atomic<bool> renderTargetsReset;	//	Set by render events, textures drawn on must be drawn again
+	long long headlessFrames;
+	int batchMatches;	//	When greater than 0, the headless run simulates a batch of matches instead of a single game
+	long long snapshotBenchRounds;	//	When greater than 0, the headless run measures saving and restoring the match instead
+	int tickRate;	//	Simulation ticks per second
+	Uint64 seed;	//	Seed of the match (or of the batch), the same seed and inputs play the same match
+	bool seeded;	//	True when the seed was given, otherwise the game picks one at random
+	long long tickNanos;	//	Duration of a simulation tick
+	long long accumulatorNanos;	//	Time passed and not simulated yet
+	steady_clock::time_point lastFrameTime;
+	FramePacer * framePacer;	//	Frame rate regulation of the render loop (not used on webgl, where the browser regulates it)
+	FramePacer * simulationPacer;	//	Tick rate regulation of the simulation loop, when it runs on its own
+	string tracePath;	//	When not empty, frame timings are saved here as a Chrome trace on exit
+	string recordPath;	//	When not empty, the match is recorded and saved here as a replay on exit
+	string replayPath;	//	When not empty, the match is played back from this replay instead of the players
 	vector<IUpdatable *> updateQueue;
 	vector<IRenderable *> renderQueue;
 } EngineData;
 typedef struct
 {
 	PongGame * pongGame;
-	Mix_Music * bgm;
+	ReplayRecorder * replayRecorder;
+	ReplayPlayer * replayPlayer;
+	Asset * bgm;
+	bool bgmStarted;	//	Music is loaded in the background, it starts as soon as it's ready
 } GameData;
 typedef struct
 {
@@ -155,10 +241,26 @@ typedef struct
 #pragma endregion
 
 //	Forward declarations
+void ParseCommandLine(int argc, char * argv[]);
+int ReplaySetup();
 int SystemSetup();
+int RendererSetup();
 void StartMusic();
+void UpdateMusic();
 void MainLoop();
+void PollEvents();
+void Simulate();
+void RenderFrame();
+#ifndef __EMSCRIPTEN__
+void SimulationLoop();
+void RenderLoop();
+#endif
+void HeadlessLoop();
+void BatchLoop();
+void SnapshotBenchLoop();
 void StopMusic();
+void FinishReplay();
+void GameShutdown();
 void SystemShutdown();
 
 //	Prepare a global context for the main loop and the main function
@@ -167,6 +269,12 @@ Context ctx;
 /*	ENTRY POINT	*/
 int main(int argc, char * argv[])
 {
+#pragma region Command Line
+	ParseCommandLine(argc, argv);
+	if(ReplaySetup() != 0)
+		return -1;
+#pragma endregion
+
 #pragma region System Setup
 	/*
 	 * Here we're going to initialize and set up
@@ -178,7 +286,8 @@ int main(int argc, char * argv[])
 	if(setupResult != 0)
 		return setupResult;
 
-	StartMusic();
+	if(!ctx.system.headless)
+		StartMusic();
 #pragma endregion
 
 #pragma region Console splash screen
@@ -194,7 +303,7 @@ int main(int argc, char * argv[])
 	{
 		//	Build the full path for the title raw resource
 		ostringstream titleFullPath;
-		titleFullPath << SDL_GetBasePath() << "res\\" << "raw\\title.aa";
+		titleFullPath << PathUtils::GetBasePath() << "res\\" << "raw\\title.aa";
 
 		//	Open the title resource as input for read
 		ifstream inputFile(titleFullPath.str());
@@ -213,10 +322,22 @@ int main(int argc, char * argv[])
 #pragma endregion
 
 #pragma region Gameplay Setup
-	ctx.game.pongGame = new PongGame(ctx.system.viewportWidth, ctx.system.viewportHeight);
+	//	Batch runs don't need a game instance, the batch simulator owns the state of all matches
+	if(ctx.engine.batchMatches <= 0)
+	{
+		ctx.game.pongGame = new PongGame(ctx.system.viewportWidth, ctx.system.viewportHeight, ctx.system.headless, ctx.engine.tickRate, ctx.engine.seed);
+
+		ctx.game.pongGame->SetReplayPlayer(ctx.game.replayPlayer);
+		if(!ctx.engine.recordPath.empty())
+		{
+			ctx.game.replayRecorder = new ReplayRecorder(ctx.engine.seed, ctx.engine.tickRate, ctx.system.viewportWidth, ctx.system.viewportHeight);
+			ctx.game.pongGame->SetReplayRecorder(ctx.game.replayRecorder);
+		}
 
-	ctx.engine.updateQueue.push_back(ctx.game.pongGame);
-	ctx.engine.renderQueue.push_back(ctx.game.pongGame);
+		ctx.engine.updateQueue.push_back(ctx.game.pongGame);
+		if(!ctx.system.headless)
+			ctx.engine.renderQueue.push_back(ctx.game.pongGame);
+	}
 #pragma endregion
 
 #pragma region Main Loop
@@ -226,11 +347,33 @@ int main(int argc, char * argv[])
 	 * Here all game logic will hook and run, frame
 	 * by frame.
 	 */
+	ctx.engine.tickNanos = 1000000000LL / ctx.engine.tickRate;
+	ctx.engine.accumulatorNanos = 0;
+	ctx.engine.lastFrameTime = steady_clock::now();
+#ifndef __EMSCRIPTEN__
+	if(!ctx.system.headless)
+		ctx.engine.framePacer = new FramePacer(ctx.system.refreshRate);
+#endif
 #ifdef __EMSCRIPTEN__
 	emscripten_set_main_loop(MainLoop, 0, 1);
 #else
-	while(!ctx.engine.closeRequested)
-		MainLoop();
+	if(ctx.engine.batchMatches > 0)
+		BatchLoop();
+	else if(ctx.engine.snapshotBenchRounds > 0)
+		SnapshotBenchLoop();
+	else if(ctx.system.headless)
+		HeadlessLoop();
+	else if(ctx.engine.threadedRendering)
+	{
+		//	Rendering on its own thread, simulation here (see SimulationLoop())
+		ctx.engine.simulationPacer = new FramePacer(ctx.engine.tickRate);
+		ctx.engine.renderThread = thread(RenderLoop);
+		SimulationLoop();
+		ctx.engine.renderThread.join();
+	}
+	else
+		while(!ctx.engine.closeRequested)
+			MainLoop();
 #endif
 #pragma endregion
 
@@ -257,8 +400,151 @@ int main(int argc, char * argv[])
 	return 0;
 }
 
+void ParseCommandLine(int argc, char * argv[])
+{
+	//	Defaults
+	ctx.system.headless = false;
+	ctx.engine.threadedRendering = false;
+	ctx.engine.headlessFrames = 0;
+	ctx.engine.batchMatches = 0;
+	ctx.engine.snapshotBenchRounds = 0;
+	ctx.engine.tickRate = DEFAULT_TICK_RATE;
+	ctx.engine.seeded = false;
+
+	/*
+	 * Command line arguments are ignored when targetting
+	 * webgl, the browser is the only way to run the game.
+	 */
+#ifndef __EMSCRIPTEN__
+	ctx.engine.threadedRendering = true;
+	for(int i = 1; i < argc; i++)
+	{
+		const string arg = argv[i];
+
+		//	--headless [frames]
+		if(arg == HEADLESS_ARG)
+		{
+			ctx.system.headless = true;
+			ctx.engine.headlessFrames = HEADLESS_DEFAULT_FRAMES;
+			if(i + 1 < argc && isdigit(argv[i + 1][0]))
+				ctx.engine.headlessFrames = atoll(argv[++i]);
+		}
+		//	--batch [matches [frames]] (implies --headless)
+		else if(arg == BATCH_ARG)
+		{
+			ctx.system.headless = true;
+			ctx.engine.headlessFrames = HEADLESS_DEFAULT_FRAMES;
+			ctx.engine.batchMatches = BATCH_DEFAULT_MATCHES;
+			if(i + 1 < argc && isdigit(argv[i + 1][0]))
+				ctx.engine.batchMatches = atoi(argv[++i]);
+			if(i + 1 < argc && isdigit(argv[i + 1][0]))
+				ctx.engine.headlessFrames = atoll(argv[++i]);
+		}
+		//	--snapshot-bench [rounds] (implies --headless)
+		else if(arg == SNAPSHOT_BENCH_ARG)
+		{
+			ctx.system.headless = true;
+			ctx.engine.headlessFrames = HEADLESS_DEFAULT_FRAMES;
+			ctx.engine.snapshotBenchRounds = SNAPSHOT_BENCH_DEFAULT_ROUNDS;
+			if(i + 1 < argc && isdigit(argv[i + 1][0]))
+				ctx.engine.snapshotBenchRounds = atoll(argv[++i]);
+		}
+		//	--trace file
+		else if(arg == TRACE_ARG && i + 1 < argc)
+			ctx.engine.tracePath = argv[++i];
+		//	--single-thread
+		else if(arg == SINGLE_THREAD_ARG)
+			ctx.engine.threadedRendering = false;
+		//	--tick-rate hz
+		else if(arg == TICK_RATE_ARG && i + 1 < argc && isdigit(argv[i + 1][0]))
+		{
+			ctx.engine.tickRate = atoi(argv[++i]);
+			if(ctx.engine.tickRate <= 0)
+				ctx.engine.tickRate = DEFAULT_TICK_RATE;
+		}
+		//	--seed number
+		else if(arg == SEED_ARG && i + 1 < argc && isdigit(argv[i + 1][0]))
+		{
+			ctx.engine.seed = strtoull(argv[++i], nullptr, 10);
+			ctx.engine.seeded = true;
+		}
+		//	--record file
+		else if(arg == RECORD_ARG && i + 1 < argc)
+			ctx.engine.recordPath = argv[++i];
+		//	--replay file
+		else if(arg == REPLAY_ARG && i + 1 < argc)
+			ctx.engine.replayPath = argv[++i];
+	}
+
+	//	Nothing is rendered in headless runs
+	if(ctx.system.headless)
+		ctx.engine.threadedRendering = false;
+#endif
+
+	//	Unless told otherwise, each run plays a different match (the system is asked for a seed only once)
+	if(!ctx.engine.seeded)
+	{
+		random_device device;
+		ctx.engine.seed = ((Uint64)device() << 32) | device();
+	}
+}
+
+int ReplaySetup()
+{
+	if(ctx.engine.replayPath.empty())
+		return 0;
+
+	ctx.game.replayPlayer = new ReplayPlayer();
+	if(!ctx.game.replayPlayer->Load(ctx.engine.replayPath))
+	{
+		delete ctx.game.replayPlayer;
+		ctx.game.replayPlayer = nullptr;
+		return -1;
+	}
+
+	/*
+	 * The match is played again exactly only with the
+	 * same seed and settings it was recorded with (the
+	 * field size is applied by SystemSetup()), a headless
+	 * run plays all of it.
+	 */
+	const ReplayHeader & header = ctx.game.replayPlayer->GetHeader();
+	ctx.engine.seed = header.seed;
+	ctx.engine.seeded = true;
+	ctx.engine.tickRate = header.tickRate;
+	ctx.engine.batchMatches = 0;
+	if(ctx.system.headless)
+		ctx.engine.headlessFrames = header.tickCount;
+	return 0;
+}
+
 int SystemSetup()
 {
+#ifndef __EMSCRIPTEN__
+	/*
+	 * A headless run only needs the SDL core (for timing
+	 * and utilities): no window, no renderer, no audio
+	 * and no font/image/mixer modules.
+	 */
+	if(ctx.system.headless)
+	{
+		if(SDL_Init(0) < 0)
+		{
+			cout << "Couldn't initialize SDL2: " << SDL_GetError() << endl;
+			return -1;
+		}
+		ctx.system.viewportWidth = HEADLESS_VIEWPORT_W;
+		ctx.system.viewportHeight = HEADLESS_VIEWPORT_H;
+		if(ctx.game.replayPlayer)
+		{
+			ctx.system.viewportWidth = ctx.game.replayPlayer->GetHeader().fieldWidth;
+			ctx.system.viewportHeight = ctx.game.replayPlayer->GetHeader().fieldHeight;
+		}
+		ctx.system.refreshRate = 0;
+		return 0;
+	}
+#endif
+
 	//	Initialize SDL (here we can selectively initialize different modules using SDL_INIT_* OR'd constants)
 	if(SDL_Init(SDL_INIT_MODE) < 0)
 	{
@@ -281,6 +567,12 @@ int SystemSetup()
 		ctx.system.viewportWidth = VIEWPORT_W;
 		ctx.system.viewportHeight = VIEWPORT_H;
 	}
+	//	Replays are shown on the field they were recorded on, whatever the display
+	if(ctx.game.replayPlayer)
+	{
+		ctx.system.viewportWidth = ctx.game.replayPlayer->GetHeader().fieldWidth;
+		ctx.system.viewportHeight = ctx.game.replayPlayer->GetHeader().fieldHeight;
+	}
 #else
 	emscripten_get_canvas_element_size(HTML_CANVAS_SELECTOR, &ctx.system.viewportWidth, &ctx.system.viewportHeight);
 #endif
@@ -298,29 +590,24 @@ int SystemSetup()
 		return -1;
 	}
 
-	//	Get or create a rendeer for future render operations
-	ctx.system.r = SDL_GetRenderer(ctx.system.window);
-	if(!ctx.system.r)
+	//	Render at the rate of the display showing the window, if known
+	SDL_DisplayMode windowDisplayMode;
+	if(SDL_GetWindowDisplayMode(ctx.system.window, &windowDisplayMode) == 0 && windowDisplayMode.refresh_rate > 0)
+		ctx.system.refreshRate = windowDisplayMode.refresh_rate;
+	else
+		ctx.system.refreshRate = TARGET_FPS;
+
+	/*
+	 * A renderer can only be used by the thread that
+	 * created it: when rendering runs on its own thread,
+	 * that's where it's created (see RenderLoop()).
+	 */
+	if(!ctx.engine.threadedRendering)
 	{
-#ifdef _DEBUG
-		cout << "Couldn't get SDL renderer from window: " << SDL_GetError() << endl;
-		cout << "Trying to create a new renderer.." << endl;
-#endif
-		ctx.system.r = SDL_CreateRenderer(ctx.system.window, -1, SDL_RendererFlags::SDL_RENDERER_ACCELERATED);
-		if(!ctx.system.r)
-		{
-			cout << "Couldn't create SDL renderer on window: " << SDL_GetError() << endl;
-			return -1;
-		}
-#ifdef _DEBUG
-		else
-			cout << "Renderer created succesfully!" << endl;
-#endif
+		const int rendererResult = RendererSetup();
+		if(rendererResult != 0)
+			return rendererResult;
 	}
-#ifdef _DEBUG
-	else
-		cout << "Renderer retrieved succesfully!" << endl;
-#endif
 
 	//	Initialize the TTF module
 	if(TTF_Init() != 0)
@@ -368,6 +655,68 @@ int SystemSetup()
 		cout << "Audio device opened succesfully!" << endl;
 #endif
 
+	/*
+	 * Resources are read from a packed archive, when one
+	 * was built (see tools/respack), with a fallback on
+	 * loose files from the res directory for anything
+	 * not in it.
+	 */
+	const string archivePath = PathUtils::Combine({PathUtils::GetBasePath(), ARCHIVE_FILE_NAME});
+	const string archiveRoot = PathUtils::Combine({PathUtils::GetBasePath(), ARCHIVE_ROOT_NAME, ""});
+	if(ResourceArchive::Get().Mount(archivePath, archiveRoot))
+		cout << "Resources mounted from " << archivePath << " (" << ResourceArchive::Get().GetEntryCount() << " files)" << endl;
+#ifdef _DEBUG
+	else
+		cout << "No resource archive, reading loose files from " << archiveRoot << endl;
+#endif
+
+	return 0;
+}
+
+int RendererSetup()
+{
+	//	Get or create a rendeer for future render operations
+	ctx.system.r = SDL_GetRenderer(ctx.system.window);
+	if(!ctx.system.r)
+	{
+#ifdef _DEBUG
+		cout << "Couldn't get SDL renderer from window: " << SDL_GetError() << endl;
+		cout << "Trying to create a new renderer.." << endl;
+#endif
+		ctx.system.r = SDL_CreateRenderer(ctx.system.window, -1, SDL_RendererFlags::SDL_RENDERER_ACCELERATED);
+		if(!ctx.system.r)
+		{
+			cout << "Couldn't create SDL renderer on window: " << SDL_GetError() << endl;
+			return -1;
+		}
+#ifdef _DEBUG
+		else
+			cout << "Renderer created succesfully!" << endl;
+#endif
+	}
+#ifdef _DEBUG
+	else
+		cout << "Renderer retrieved succesfully!" << endl;
+#endif
+
+	/*
+	 * The software renderer (e.g. forced with the
+	 * SDL_RENDER_DRIVER=software environment variable)
+	 * draws on the window surface, which keeps its pixels
+	 * from frame to frame: only what changed needs to be
+	 * drawn again. Accelerated renderers don't guarantee
+	 * anything about the back buffer after a present, they
+	 * always draw full frames.
+	 */
+	SDL_RendererInfo rendererInfo;
+	if(SDL_GetRendererInfo(ctx.system.r, &rendererInfo) == 0 && (rendererInfo.flags & SDL_RENDERER_SOFTWARE))
+	{
+		DirtyRects::Get().Enable(ctx.system.viewportWidth, ctx.system.viewportHeight);
+#ifdef _DEBUG
+		cout << "Software renderer, drawing changed regions only" << endl;
+#endif
+	}
+
 	return 0;
 }
 
@@ -376,7 +725,7 @@ void StartMusic()
 	//	Load music from file
 	string bgmFullPath = PathUtils::Combine(
 		{
-			SDL_GetBasePath(),
+			PathUtils::GetBasePath(),
 			"res",
 			"sound",
 			"bgm",
@@ -384,13 +733,20 @@ void StartMusic()
 		}
 	);
 
-	ctx.game.bgm = Mix_LoadMUS(bgmFullPath.c_str());
+	//	Request the music, it will start playing as soon as it's loaded (see UpdateMusic())
+	ctx.game.bgm = AssetManager::Get().LoadMusic(bgmFullPath);
+	ctx.game.bgmStarted = false;
+}
 
-	//	Start music, if load succeeded
-	if(ctx.game.bgm)
-		Mix_FadeInMusic(ctx.game.bgm, -1, BGM_FADE_IN_TIME);
-	else
-		cout << "Couldn't load music from " << bgmFullPath << " [ERROR]: " << Mix_GetError() << endl;
+void UpdateMusic()
+{
+	//	Start music once, if load succeeded (the asset manager reports loading errors)
+	if(ctx.game.bgmStarted || !ctx.game.bgm || ctx.game.bgm->IsLoading())
+		return;
+
+	if(ctx.game.bgm->IsReady())
+		Mix_FadeInMusic(ctx.game.bgm->GetMusic(), -1, BGM_FADE_IN_TIME);
+	ctx.game.bgmStarted = true;
 }
 
 void MainLoop()
@@ -401,11 +757,9 @@ void MainLoop()
 	 * a unit of calculation that results in an image which
 	 * will be presented to the player).
 	 * Here's a breakdown of the stages:
-	 * - FPS Regulation (pt1):
-	 *		keep track of the current time to check how long
-	 *		it took to calculate the entire frame and allows
-	 *		for frame-time consistency at (pt2)
-	 *		(this operation is not needed on all platforms)
+	 * - Profiling:
+	 *		each stage is timed by the frame profiler, which
+	 *		keeps the timings of the last frames in memory
 	 * - Events/Input:
 	 *		poll and consume all system events such as
 	 *		hardware interrupts or window events and use
@@ -414,8 +768,11 @@ void MainLoop()
 	 * - Update:
 	 *		here an update message is broadcasted to all
 	 *		game elements which subscribed to it, this is the
-	 *		place where the game logic happens each frame and
-	 *		where al modifications to the game state happen
+	 *		place where the game logic happens and where all
+	 *		modifications to the game state happen; the game
+	 *		logic runs at a fixed tick rate, so a frame can
+	 *		contain zero, one or more updates depending on how
+	 *		much time passed since the previous frame
 	 * - Pre-Render:
 	 *		an intermediate stage between update and render,
 	 *		useful to make last changes after all the game
@@ -428,11 +785,10 @@ void MainLoop()
 	 *		finally, the back and front buffers are swapped and
 	 *		the final image is show to the player (during this
 	 *		stage no modifications to the game state are allowed)
-	 * - FPS Regulation (pt2):
-	 *		based on data collected here and at (pt1), and
-	 *		based on the target frame time, here it is calculated
-	 *		a delay to wait to meet the target frame rate and
-	 *		not overshoot it
+	 * - FPS Regulation:
+	 *		wait for the end of the frame time, so that frames
+	 *		are presented at a steady rate and never faster
+	 *		than the target frame rate
 	 *		(this operation is not needed on all platforms)
 	 * - WebGL Shutdown:
 	 *		a very specific stage, the reason for it is that
@@ -440,36 +796,86 @@ void MainLoop()
 	 *		the game code (the browser controls it) so here we
 	 *		make specific operations that allow to shutdow the
 	 *		application following the browser's logic
+	 *
+	 * This is the loop running everything on a single
+	 * thread (on webgl and with --single-thread), see
+	 * SimulationLoop() and RenderLoop() for the same
+	 * stages split on two threads.
 	 */
-#pragma region Prepare FPS Regulation
+#pragma region Profiling
+	FrameProfiler & profiler = FrameProfiler::Get();
+	profiler.BeginFrame();
+#pragma endregion
+
+#pragma region Events/Input Loop
+	profiler.BeginStage(PS_Events);
+	PollEvents();
+	profiler.EndStage(PS_Events);
+#pragma endregion
+
+#pragma region Update Loop (Logic)
+	profiler.BeginStage(PS_Update);
+	Simulate();
+	profiler.EndStage(PS_Update);
+#pragma endregion
+
+#pragma region Render Loop
+	RenderFrame();
+#pragma endregion
+
+#pragma region FPS Regulation
 	/*
-	 * To keep a steady frame rate, we need to know
-	 * how long it takes for a frame to make all
-	 * calculations and render and then wait for the
-	 * target frame time.
-	 * To do so, when the frame starts, i.e. when
-	 * entering the main 
-	 * 
+	 * The frame pacer waits until the end of this frame's
+	 * time slot, with sub-millisecond precision (see
+	 * FramePacer for details).
+	 * If the frame took longer than the frame time we just
+	 * don't wait and rush into the next frame: the simulation
+	 * doesn't depend on the frame rate, it will catch up
+	 * with more ticks in the next frame.
+	 *
 	 * When building for webgl, we let the browser decide
 	 * the frame rate, which will typically match the
 	 * monitor's refresh rate, so we're skipping all the
-	 * framerate regulation stuff when targetting webgl.loop, we store the precise
-	 * time.
+	 * framerate regulation stuff when targetting webgl.
 	 */
 #ifndef __EMSCRIPTEN__
-	steady_clock::time_point frameStart = high_resolution_clock::now();
+	profiler.BeginStage(PS_Pacing);
+	ctx.engine.framePacer->Wait();
+	profiler.EndStage(PS_Pacing);
 #endif
 #pragma endregion
 
-#pragma region Events/Input Loop
-		/*
-		 * Here we handle all the main events coming from
-		 * both the OS and the input.
-		 * NOTE: Here we receive all the events but we
-		 * can filter what events are added to the queue
-		 * from which SDL_PollEvent reads using a filter:
-		 * see https://wiki.libsdl.org/SDL2/SDL_EventFilter
-		 */
+#pragma region Profiling
+	profiler.EndFrame();
+#pragma endregion
+
+#pragma region WebGL Shutdown
+	/*
+	 * When targetting webgl this function (MainLoop) is
+	 * called again and again by the browser. When the
+	 * game requests a close, we need to shutdown the
+	 * system.
+	 */
+#ifdef __EMSCRIPTEN__
+	if(ctx.engine.closeRequested)
+		SystemShutdown();
+#endif
+#pragma endregion
+}
+
+void PollEvents()
+{
+	/*
+	 * Here we handle all the main events coming from
+	 * both the OS and the input.
+	 * NOTE: Here we receive all the events but we
+	 * can filter what events are added to the queue
+	 * from which SDL_PollEvent reads using a filter:
+	 * see https://wiki.libsdl.org/SDL2/SDL_EventFilter
+	 * Events concerning the renderer are only recorded
+	 * here, the thread rendering reacts to them before
+	 * drawing its next frame.
+	 */
 	SDL_Event currentEvent;
 	while(SDL_PollEvent(&currentEvent))
 	{
@@ -485,7 +891,7 @@ void MainLoop()
 				break;
 #endif
 			case SDL_EventType::SDL_KEYDOWN:
-				Input::Get().NotifyKeyDown(currentEvent.key.keysym.sym);
+				Input::Get().NotifyKeyDown(currentEvent.key.keysym.scancode, currentEvent.key.timestamp);
 #ifndef __EMSCRIPTEN__
 					/*
 					 * Not handling escape button when targetting
@@ -496,76 +902,334 @@ void MainLoop()
 #endif
 				break;
 			case SDL_EventType::SDL_KEYUP:
-				Input::Get().NotifyKeyUp(currentEvent.key.keysym.sym);
+				Input::Get().NotifyKeyUp(currentEvent.key.keysym.scancode, currentEvent.key.timestamp);
+				break;
+			case SDL_EventType::SDL_WINDOWEVENT:
+				//	The window content may have been lost or scaled, draw it all again
+				if(
+					currentEvent.window.event == SDL_WINDOWEVENT_EXPOSED ||
+					currentEvent.window.event == SDL_WINDOWEVENT_SIZE_CHANGED ||
+					currentEvent.window.event == SDL_WINDOWEVENT_RESTORED
+					)
+					ctx.engine.fullRedrawRequested = true;
+				break;
+			case SDL_EventType::SDL_RENDER_TARGETS_RESET:
+				//	Textures drawn on by the renderer lost their content
+				ctx.engine.renderTargetsReset = true;
 				break;
 		}
 	}
-#pragma endregion
+}
 
-#pragma region Update Loop (Logic)
-	for(IUpdatable *& updatable : ctx.engine.updateQueue)
-		updatable->Update();
-#pragma endregion
+void Simulate()
+{
+	/*
+	 * The time passed since the previous frame is added
+	 * to an accumulator, which is then consumed in fixed
+	 * ticks: each tick is a full update of the game.
+	 * This way the game logic always advances by the same
+	 * amount of time per update (so it's deterministic and
+	 * doesn't depend on the render frame rate) and, on
+	 * average, as fast as the real time.
+	 * What's left in the accumulator (less than a tick)
+	 * tells how far the real time is between the last
+	 * two simulated states, which is used to interpolate
+	 * the rendering.
+	 */
+	const steady_clock::time_point now = steady_clock::now();
+	const Uint32 nowTicks = SDL_GetTicks();	//	Same clock as input timestamps
+	long long frameNanos = duration_cast<nanoseconds>(now - ctx.engine.lastFrameTime).count();
+	ctx.engine.lastFrameTime = now;
+	if(frameNanos > MAX_FRAME_TIME_NS)
+		frameNanos = MAX_FRAME_TIME_NS;
+	ctx.engine.accumulatorNanos += frameNanos;
+
+	int ticks = 0;
+	while(ctx.engine.accumulatorNanos >= ctx.engine.tickNanos && ticks < MAX_TICKS_PER_FRAME)
+	{
+		//	The tick simulates from what's left in the accumulator ago, to one tick later
+		const double tickStart = -ctx.engine.accumulatorNanos / 1000000.0;
+		Input::Get().BeginTick(nowTicks, tickStart, tickStart + ctx.engine.tickNanos / 1000000.0);
+		for(IUpdatable *& updatable : ctx.engine.updateQueue)
+			updatable->Update();
+		Input::Get().EndTick();
+		ctx.engine.accumulatorNanos -= ctx.engine.tickNanos;
+		ticks++;
+	}
+
+	//	Too far behind to catch up, drop the backlog rather than spiraling into longer and longer frames
+	if(ctx.engine.accumulatorNanos >= ctx.engine.tickNanos)
+		ctx.engine.accumulatorNanos %= ctx.engine.tickNanos;
+
+	//	Hand the state just simulated over to rendering
+	if(ctx.game.pongGame)
+		ctx.game.pongGame->Publish(ctx.engine.accumulatorNanos);
+
+	//	A replay played back at its pace is over with its last tick
+	if(ctx.game.replayPlayer && ctx.game.replayPlayer->IsOver())
+		ctx.engine.closeRequested = true;
+
+	FrameProfiler::Get().AddTicks(ticks);
+}
+
+void RenderFrame()
+{
+	FrameProfiler & profiler = FrameProfiler::Get();
+
+	//	React to the events recorded while polling
+	if(ctx.engine.fullRedrawRequested.exchange(false))
+		DirtyRects::Get().InvalidateAll();
+	if(ctx.engine.renderTargetsReset.exchange(false))
+		StaticLayer::InvalidateAll();
+
+	//	Complete assets loaded in the background (uploading textures) and start the music when it's ready
+	profiler.BeginStage(PS_PreRender);
+	AssetManager::Get().Update(ctx.system.r);
+	UpdateMusic();
 
-#pragma region Render Loop
 	//	Send a pre-render message to all subscribers so they can prepare for rendering
 	for(IRenderable * const & renderable : ctx.engine.renderQueue)
 		renderable->PreRender(ctx.system.r);
+	profiler.EndStage(PS_PreRender);
 
-	//	Let's clear the canvas before drawing a new frame
-	SDL_SetRenderDrawColor(ctx.system.r, RENDER_CLEAR_COLOR);
-	SDL_RenderClear(ctx.system.r);
+	DirtyRects & dirtyRects = DirtyRects::Get();
+	const bool fullFrame = dirtyRects.IsFullFrame();
+	profiler.BeginStage(PS_Render);
+	if(fullFrame)
+	{
+		//	Let's clear the canvas before drawing a new frame
+		SDL_SetRenderDrawColor(ctx.system.r, RENDER_CLEAR_COLOR);
+		SDL_RenderClear(ctx.system.r);
 
-	//	Draw all renderables to the back buffer (Render is a const function)
-	for(const IRenderable * const & renderable : ctx.engine.renderQueue)
-		renderable->Render(ctx.system.r);
+		//	Draw all renderables to the back buffer (Render is a const function)
+		for(const IRenderable * const & renderable : ctx.engine.renderQueue)
+			renderable->Render(ctx.system.r);
+		//	Draw the rects still queued, nothing drew on top of them
+		RenderBatcher::Get().Flush(ctx.system.r);
+	}
+	else
+	{
+		/*
+		 * Only the changed regions are drawn, the rest of
+		 * the back buffer still holds the previous frame.
+		 * Each region is cleared and drawn like a full frame
+		 * but with a clip rect, so only its pixels are filled
+		 * (clearing ignores the clip rect, a fill is used).
+		 */
+		for(const SDL_Rect & region : dirtyRects.GetRects())
+		{
+			SDL_RenderSetClipRect(ctx.system.r, &region);
+			RenderBatcher::Get().FillRect(region, SDL_Color{RENDER_CLEAR_COLOR});
+			for(const IRenderable * const & renderable : ctx.engine.renderQueue)
+				renderable->Render(ctx.system.r);
+			RenderBatcher::Get().Flush(ctx.system.r);
+		}
+		SDL_RenderSetClipRect(ctx.system.r, nullptr);
+	}
+	profiler.EndStage(PS_Render);
 
 	//	Swap front and back buffer to show results of the render
-	SDL_RenderPresent(ctx.system.r);
-#pragma endregion
+	profiler.BeginStage(PS_Present);
+	if(fullFrame)
+		SDL_RenderPresent(ctx.system.r);
+	else if(!dirtyRects.GetRects().empty())
+	{
+		//	Copy the changed regions only to the screen (when nothing changed, there's nothing to copy)
+		SDL_RenderFlush(ctx.system.r);
+		SDL_UpdateWindowSurfaceRects(ctx.system.window, dirtyRects.GetRects().data(), (int)dirtyRects.GetRects().size());
+	}
+	profiler.EndStage(PS_Present);
+	RenderBatcher::Get().EndFrame();
+	dirtyRects.Clear();
+}
 
-#pragma region FPS Regulation
+#ifndef __EMSCRIPTEN__
+void SimulationLoop()
+{
 	/*
-	 * We calculate the frame time, relative to the frame start time.
-	 * If it's below the target frame time, we'll wait for the difference.
-	 * If, instead, the frame take longer than the frame time we have two
-	 * roads to walk:
-	 * - variable frame time: we just don't wait and rush into the next frame
-	 * - fixed frame time: we skip a frame to align to the next fixed frame time
-	 *
-	 * Important note: when working with high resolution clock (or numbers
-	 * in general), data is usually stored in large data formats such as
-	 * long int or even long long int, so it's good practice to avoid
-	 * implicit conversions to make 100% clear what type of data we're
-	 * carying around.
-	 * 
-	 * As stated above, FPS regulation is entrusted to the browser for
-	 * webgl builds, so we'll skip the manual frame rate regulation here
-	 * too.
+	 * The main thread keeps polling events (SDL wants
+	 * them polled by the thread that created the window)
+	 * and simulating, at the tick rate, while frames
+	 * are rendered on their own thread: a slow frame
+	 * doesn't delay input and simulation and a burst of
+	 * ticks doesn't delay the next frame.
+	 * Each simulation step publishes a snapshot of the
+	 * game (see PongGame::Publish()), rendering only ever
+	 * reads the latest one.
+	 * Timings are reported to the profiler, which puts
+	 * them in the frame rendered when they're reported.
 	 */
-#ifndef __EMSCRIPTEN__
-	long long elapsedMillis = duration_cast<milliseconds>(high_resolution_clock::now() - frameStart).count();
-#ifdef FRAME_SKIP
-	elapsedMillis %= TARGET_FPS;
-#endif
-	long long waitMillis = (1000 / TARGET_FPS) - elapsedMillis;
-	if(waitMillis > 0)
-		SDL_Delay((int)waitMillis);
+	FrameProfiler & profiler = FrameProfiler::Get();
+	while(!ctx.engine.closeRequested)
+	{
+		const Uint64 eventsStart = SDL_GetPerformanceCounter();
+		PollEvents();
+		const Uint64 updateStart = SDL_GetPerformanceCounter();
+		Simulate();
+		const Uint64 updateEnd = SDL_GetPerformanceCounter();
+		profiler.ReportStage(PS_Events, eventsStart, updateStart);
+		profiler.ReportStage(PS_Update, updateStart, updateEnd);
+
+		ctx.engine.simulationPacer->Wait();
+	}
+
+	//	The game is still alive until the render thread sees this
+	FinishReplay();
+	ctx.engine.simulationStopped = true;
+}
+
+void RenderLoop()
+{
+	//	The renderer belongs to this thread, from creation to destruction
+	if(RendererSetup() != 0)
+	{
+		//	Nothing can be rendered: stop the simulation and, once it's over, dispose the game anyway
+		ctx.engine.closeRequested = true;
+		while(!ctx.engine.simulationStopped)
+			SDL_Delay(1);
+		GameShutdown();
+		return;
+	}
+
+	FrameProfiler & profiler = FrameProfiler::Get();
+	while(!ctx.engine.simulationStopped)
+	{
+		profiler.BeginFrame();
+		RenderFrame();
+
+		profiler.BeginStage(PS_Pacing);
+		ctx.engine.framePacer->Wait();
+		profiler.EndStage(PS_Pacing);
+		profiler.EndFrame();
+	}
+
+	//	The simulation stopped too, what's left of the game is disposed here, with the renderer still alive
+	GameShutdown();
+}
 #endif
-#pragma endregion
 
-#pragma region WebGL Shutdown
+void HeadlessLoop()
+{
 	/*
-	 * When targetting webgl this function (MainLoop) is
-	 * called again and again by the browser. When the
-	 * game requests a close, we need to shutdown the
-	 * system.
+	 * With no window there are no events to poll, nothing
+	 * to render and no frame rate to regulate: frames are
+	 * simulated back to back, as fast as possible.
+	 * There's no player either, so we hold the kick-off key
+	 * down for the whole run, which kicks the ball off
+	 * again right after each point.
 	 */
-#ifdef __EMSCRIPTEN__
-	if(ctx.engine.closeRequested)
-		SystemShutdown();
-#endif
-#pragma endregion
+	Input::Get().NotifyKeyDown(SDL_SCANCODE_SPACE);
+
+	steady_clock::time_point runStart = steady_clock::now();
+	for(long long frame = 0; frame < ctx.engine.headlessFrames; frame++)
+	{
+		for(IUpdatable *& updatable : ctx.engine.updateQueue)
+			updatable->Update();
+		Input::Get().EndTick();
+	}
+	long long elapsedMicros = duration_cast<microseconds>(steady_clock::now() - runStart).count();
+
+	//	Report the outcome of the simulation
+	cout << "Simulated " << ctx.engine.headlessFrames << " frames in " << elapsedMicros / 1000.0 << "ms";
+	if(elapsedMicros > 0)
+		cout << " (" << (long long)(ctx.engine.headlessFrames * 1000000.0 / elapsedMicros) << " frames/s, " << (long long)(ctx.engine.headlessFrames * 1000000.0 / elapsedMicros / ctx.engine.tickRate) << "x real time)";
+	cout << endl;
+	cout << "Final score: " << ctx.game.pongGame->GetScoreP1() << " - " << ctx.game.pongGame->GetScoreP2() << endl;
+	cout << "Seed: " << ctx.game.pongGame->GetSeed() << endl;
+}
+
+void BatchLoop()
+{
+	/*
+	 * Same as HeadlessLoop() but for many matches at
+	 * once: the batch simulator advances all of them
+	 * in a single call, spreading matches across all
+	 * the cores.
+	 */
+	WorkerPool pool;
+	//	Batches are reproducible by default, so runs can be compared
+	BatchSimulator batch(ctx.engine.batchMatches, ctx.system.viewportWidth, ctx.system.viewportHeight, ctx.engine.tickRate, ctx.engine.seeded ? ctx.engine.seed : BATCH_SEED, &pool);
+	batch.SetAllInputs(MI_KickOff);
+
+	steady_clock::time_point runStart = steady_clock::now();
+	batch.Step(ctx.engine.headlessFrames);
+	long long elapsedMicros = duration_cast<microseconds>(steady_clock::now() - runStart).count();
+
+	//	Report the outcome of the simulation
+	const long long totalSteps = ctx.engine.headlessFrames * batch.GetMatchCount();
+	cout << "Simulated " << batch.GetMatchCount() << " matches x " << ctx.engine.headlessFrames << " frames on " << pool.GetWorkerCount() + 1 << " threads in " << elapsedMicros / 1000.0 << "ms";
+	if(elapsedMicros > 0)
+		cout << " (" << (long long)(totalSteps * 1000000.0 / elapsedMicros) << " steps/s)";
+	cout << endl;
+	long long totalPoints = 0;
+	for(int match = 0; match < batch.GetMatchCount(); match++)
+		totalPoints += batch.GetScoreP1(match) + batch.GetScoreP2(match);
+	cout << "Points scored: " << totalPoints << endl;
+}
+
+void SnapshotBenchLoop()
+{
+	/*
+	 * Plays the match headless for a while, as
+	 * HeadlessLoop() does, then measures how long saving
+	 * and restoring its state takes and checks that a
+	 * restored match goes on exactly as it did after the
+	 * save.
+	 * Snapshots are cycled through a few slots, so that
+	 * no save or restore can be skipped as redundant.
+	 * Replays would go out of sync with rollbacks, so
+	 * they're left out.
+	 */
+	PongGame & game = *ctx.game.pongGame;
+	game.SetReplayRecorder(nullptr);
+	game.SetReplayPlayer(nullptr);
+	Input::Get().NotifyKeyDown(SDL_SCANCODE_SPACE);
+
+	for(long long frame = 0; frame < ctx.engine.headlessFrames; frame++)
+	{
+		game.Update();
+		Input::Get().EndTick();
+	}
+
+	//	Saves
+	PongSnapshot snapshots[SNAPSHOT_BENCH_SLOTS];
+	steady_clock::time_point runStart = steady_clock::now();
+	for(long long round = 0; round < ctx.engine.snapshotBenchRounds; round++)
+		game.Save(snapshots[round & (SNAPSHOT_BENCH_SLOTS - 1)]);
+	const long long saveNanos = duration_cast<nanoseconds>(steady_clock::now() - runStart).count();
+
+	//	Restores (all the slots hold the same state, the match is left as it was)
+	runStart = steady_clock::now();
+	for(long long round = 0; round < ctx.engine.snapshotBenchRounds; round++)
+		game.Restore(snapshots[round & (SNAPSHOT_BENCH_SLOTS - 1)]);
+	const long long restoreNanos = duration_cast<nanoseconds>(steady_clock::now() - runStart).count();
+
+	//	Rollback: the same ticks after the same state give the same match
+	PongSnapshot saved;
+	game.Save(saved);
+	for(int frame = 0; frame < SNAPSHOT_BENCH_ROLLBACK_FRAMES; frame++)
+	{
+		game.Update();
+		Input::Get().EndTick();
+	}
+	const Uint32 expectedChecksum = game.GetChecksum();
+	game.Restore(saved);
+	PongSnapshot restored;
+	game.Save(restored);
+	const bool restoredExactly = memcmp(&saved, &restored, sizeof(PongSnapshot)) == 0;
+	for(int frame = 0; frame < SNAPSHOT_BENCH_ROLLBACK_FRAMES; frame++)
+	{
+		game.Update();
+		Input::Get().EndTick();
+	}
+	const bool rolledBack = restoredExactly && game.GetChecksum() == expectedChecksum;
+
+	//	Report the outcome of the benchmark
+	cout << "Snapshot size: " << sizeof(PongSnapshot) << " bytes" << endl;
+	cout << "Saved " << ctx.engine.snapshotBenchRounds << " times in " << saveNanos / 1000000.0 << "ms (" << (double)saveNanos / ctx.engine.snapshotBenchRounds << "ns each)" << endl;
+	cout << "Restored " << ctx.engine.snapshotBenchRounds << " times in " << restoreNanos / 1000000.0 << "ms (" << (double)restoreNanos / ctx.engine.snapshotBenchRounds << "ns each)" << endl;
+	cout << "Rollback over " << SNAPSHOT_BENCH_ROLLBACK_FRAMES << " frames: " << (rolledBack ? "identical" : "MISMATCH") << endl;
+	cout << "Seed: " << game.GetSeed() << endl;
 }
 
 void StopMusic()
@@ -584,11 +1248,80 @@ void StopMusic()
 	//	Free music and reset pointer
 	if(ctx.game.bgm)
 	{
-		Mix_FreeMusic(ctx.game.bgm);
+		AssetManager::Get().Release(ctx.game.bgm);
 		ctx.game.bgm = nullptr;
 	}
 }
 
+void FinishReplay()
+{
+	if(!ctx.game.pongGame)
+		return;
+
+	const int scoreP1 = ctx.game.pongGame->GetScoreP1();
+	const int scoreP2 = ctx.game.pongGame->GetScoreP2();
+	const Uint32 checksum = ctx.game.pongGame->GetChecksum();
+
+	//	Save the match just played
+	if(ctx.game.replayRecorder)
+	{
+		if(ctx.game.replayRecorder->Save(ctx.engine.recordPath, scoreP1, scoreP2, checksum))
+			cout << "Replay of " << ctx.game.replayRecorder->GetTickCount() << " ticks saved to " << ctx.engine.recordPath << endl;
+		ctx.game.pongGame->SetReplayRecorder(nullptr);
+		delete ctx.game.replayRecorder;
+		ctx.game.replayRecorder = nullptr;
+	}
+
+	//	Tell whether playing the replay gave the match that was recorded
+	if(ctx.game.replayPlayer)
+	{
+		const ReplayHeader & header = ctx.game.replayPlayer->GetHeader();
+		if(ctx.game.replayPlayer->IsCorrupted())
+			cout << "Replay is corrupted, stopped after " << ctx.game.replayPlayer->GetTicksRead() << " ticks" << endl;
+		else if(!ctx.game.replayPlayer->IsOver())
+			cout << "Replay stopped after " << ctx.game.replayPlayer->GetTicksRead() << " of " << header.tickCount << " ticks" << endl;
+		else if(scoreP1 == header.scoreP1 && scoreP2 == header.scoreP2 && checksum == header.checksum)
+			cout << "Replay matches the recorded match (" << scoreP1 << " - " << scoreP2 << ")" << endl;
+		else
+			cout << "Replay DIVERGED from the recorded match: " << scoreP1 << " - " << scoreP2 << ", recorded " << header.scoreP1 << " - " << header.scoreP2 << endl;
+		ctx.game.pongGame->SetReplayPlayer(nullptr);
+		delete ctx.game.replayPlayer;
+		ctx.game.replayPlayer = nullptr;
+	}
+}
+
+void GameShutdown()
+{
+	/*
+	 * Everything here may own textures, so it's disposed
+	 * by the thread owning the renderer, before the
+	 * renderer itself.
+	 */
+	//	Stop playing the BGM
+	if(!ctx.system.headless)
+		StopMusic();
+
+	//	Dispose the game
+	if(ctx.game.pongGame)
+	{
+		delete ctx.game.pongGame;
+		ctx.game.pongGame = nullptr;
+	}
+
+	//	Dispose the glyph atlases shared by labels (they're textures, so before the window and its renderer, and may hold fonts)
+	GlyphAtlas::ReleaseAll();
+
+	//	Dispose all assets (waiting for those still loading), audio and fonts must still be open
+	if(!ctx.system.headless)
+		AssetManager::Get().Shutdown();
+
+	if(ctx.system.r)
+	{
+		SDL_DestroyRenderer(ctx.system.r);
+		ctx.system.r = nullptr;
+	}
+}
+
 void SystemShutdown()
 {
 	/*
@@ -606,21 +1339,49 @@ void SystemShutdown()
 	emscripten_cancel_main_loop();
 #endif
 
-	//	Stop playing the BGM
-	StopMusic();
+	//	Dispose the game, unless the render thread already did
+	if(!ctx.engine.threadedRendering)
+	{
+		FinishReplay();
+		GameShutdown();
+	}
 
-	//	Dispose the game
-	if(ctx.game.pongGame)
+	//	Report where frame time went
+	if(FrameProfiler::Get().GetFrameCount() > 0)
 	{
-		delete ctx.game.pongGame;
-		ctx.game.pongGame = nullptr;
+		FrameProfiler::Get().PrintReport();
+		if(!ctx.engine.tracePath.empty() && FrameProfiler::Get().DumpChromeTrace(ctx.engine.tracePath))
+			cout << "Frame trace saved to " << ctx.engine.tracePath << endl;
+	}
+
+	//	Report how steady the frame rate was and dispose the frame pacer
+	if(ctx.engine.framePacer)
+	{
+		ctx.engine.framePacer->PrintReport();
+		delete ctx.engine.framePacer;
+		ctx.engine.framePacer = nullptr;
+	}
+	if(ctx.engine.simulationPacer)
+	{
+		delete ctx.engine.simulationPacer;
+		ctx.engine.simulationPacer = nullptr;
 	}
 
-	//	Quit all systems
-	SDL_DestroyWindow(ctx.system.window);
-	Mix_CloseAudio();
-	Mix_Quit();
-	IMG_Quit();
-	TTF_Quit();
+	//	Report how fonts were reused and close them, SDL_ttf must still be running
+	FontCache::Get().PrintReport();
+	FontCache::Get().Clear();
+
+	//	Nothing reads from the resource archive anymore
+	ResourceArchive::Get().Unmount();
+
+	//	Quit all systems (a headless run only initialized the core)
+	if(!ctx.system.headless)
+	{
+		SDL_DestroyWindow(ctx.system.window);
+		Mix_CloseAudio();
+		Mix_Quit();
+		IMG_Quit();
+		TTF_Quit();
+	}
 	SDL_Quit();
 }
@@ -0,0 +1,176 @@
+/*
+ * Resource packer: builds the archive the game reads
+ * its resources from (see ArchiveFormat.h), out of a
+ * directory tree.
+ *
+ * Usage:
+ *	respack <resource directory> <archive> [--lz4]
+ *
+ * With --lz4, files are stored compressed when that
+ * saves at least an eighth of their size (formats
+ * that are compressed already, like png and mp3,
+ * usually don't and are stored as they are).
+ *
+ * Build (C++17, no dependencies):
+ *	g++ -std=c++17 -O2 -I"SDL Pong" tools/respack/respack.cpp "SDL Pong/Lz4.cpp" -o respack
+ */
+
+#pragma region C++ Includes
+#include <iostream>
+#include <fstream>
+#include <filesystem>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <cstring>
+#pragma endregion
+
+#pragma region Engine Includes
+#include "ArchiveFormat.h"
+#include "Lz4.h"
+#pragma endregion
+
+using namespace std;
+namespace fs = std::filesystem;
+
+#pragma region Constant Parameters
+#define LZ4_ARG "--lz4"
+//	Compressed files must be at most this fraction of the original (7/8)
+#define MIN_GAIN_NUMERATOR 7
+#define MIN_GAIN_DENOMINATOR 8
+#pragma endregion
+
+typedef struct
+{
+	string name;	//	Relative to the packed directory, '/' separators
+	vector<uint8_t> contents;	//	As stored in the archive
+	uint64_t size;	//	Original size
+	uint32_t compression;
+} PackedFile;
+
+static uint64_t Align(uint64_t offset)
+{
+	return (offset + ARCHIVE_ALIGNMENT - 1) / ARCHIVE_ALIGNMENT * ARCHIVE_ALIGNMENT;
+}
+
+static bool ReadFile(const fs::path & path, vector<uint8_t> & contents)
+{
+	ifstream file(path, ios::binary);
+	if(!file)
+		return false;
+	contents.assign(istreambuf_iterator<char>(file), istreambuf_iterator<char>());
+	return true;
+}
+
+int main(int argc, char * argv[])
+{
+	if(argc < 3)
+	{
+		cout << "Usage: respack <resource directory> <archive> [" << LZ4_ARG << "]" << endl;
+		return 1;
+	}
+	const fs::path root(argv[1]);
+	const string archivePath(argv[2]);
+	bool compress = false;
+	for(int i = 3; i < argc; i++)
+		if(strcmp(argv[i], LZ4_ARG) == 0)
+			compress = true;
+
+	if(!fs::is_directory(root))
+	{
+		cout << root.string() << " is not a directory" << endl;
+		return 1;
+	}
+
+	//	Collect all files, hidden ones excluded
+	vector<PackedFile> files;
+	for(const fs::directory_entry & entry : fs::recursive_directory_iterator(root))
+	{
+		if(!entry.is_regular_file() || entry.path().filename().string()[0] == '.')
+			continue;
+
+		PackedFile file;
+		file.name = fs::relative(entry.path(), root).generic_string();
+		vector<uint8_t> contents;
+		if(!ReadFile(entry.path(), contents))
+		{
+			cout << "Couldn't read " << entry.path().string() << endl;
+			return 1;
+		}
+		file.size = contents.size();
+		file.compression = AC_None;
+
+		if(compress && !contents.empty())
+		{
+			vector<uint8_t> compressed(Lz4::GetMaxCompressedSize(contents.size()));
+			const size_t compressedSize = Lz4::Compress(contents.data(), contents.size(), compressed.data(), compressed.size());
+			if(compressedSize > 0 && compressedSize * MIN_GAIN_DENOMINATOR <= contents.size() * MIN_GAIN_NUMERATOR)
+			{
+				compressed.resize(compressedSize);
+				contents.swap(compressed);
+				file.compression = AC_Lz4;
+			}
+		}
+		file.contents.swap(contents);
+		files.push_back(move(file));
+	}
+
+	//	The game binary searches entries by name, byte by byte
+	sort(files.begin(), files.end(), [](const PackedFile & a, const PackedFile & b) { return strcmp(a.name.c_str(), b.name.c_str()) < 0; });
+
+	//	Lay out the names, then the contents
+	ArchiveHeader header;
+	memcpy(header.magic, ARCHIVE_MAGIC, ARCHIVE_MAGIC_SIZE);
+	header.version = ARCHIVE_VERSION;
+	header.entryCount = (uint32_t)files.size();
+	header.namesSize = 0;
+	vector<ArchiveEntry> entries(files.size());
+	for(size_t i = 0; i < files.size(); i++)
+	{
+		entries[i].nameOffset = header.namesSize;
+		entries[i].nameLength = (uint32_t)files[i].name.size();
+		header.namesSize += entries[i].nameLength + 1;
+	}
+	uint64_t offset = sizeof(ArchiveHeader) + entries.size() * sizeof(ArchiveEntry) + header.namesSize;
+	for(size_t i = 0; i < files.size(); i++)
+	{
+		offset = Align(offset);
+		entries[i].offset = offset;
+		entries[i].storedSize = files[i].contents.size();
+		entries[i].size = files[i].size;
+		entries[i].compression = files[i].compression;
+		entries[i].reserved = 0;
+		offset += entries[i].storedSize;
+	}
+
+	ofstream archive(archivePath, ios::binary);
+	if(!archive)
+	{
+		cout << "Couldn't create " << archivePath << endl;
+		return 1;
+	}
+	archive.write((const char *)&header, sizeof(header));
+	archive.write((const char *)entries.data(), entries.size() * sizeof(ArchiveEntry));
+	for(const PackedFile & file : files)
+		archive.write(file.name.c_str(), file.name.size() + 1);
+	for(size_t i = 0; i < files.size(); i++)
+	{
+		//	Pad up to the aligned offset of the file
+		static const char padding[ARCHIVE_ALIGNMENT] = { };
+		archive.write(padding, entries[i].offset - (uint64_t)archive.tellp());
+		archive.write((const char *)files[i].contents.data(), files[i].contents.size());
+
+		cout << files[i].name << ": " << files[i].size << " bytes";
+		if(files[i].compression == AC_Lz4)
+			cout << ", " << files[i].contents.size() << " compressed";
+		cout << endl;
+	}
+	if(!archive)
+	{
+		cout << "Couldn't write " << archivePath << endl;
+		return 1;
+	}
+
+	cout << "Packed " << files.size() << " files into " << archivePath << " (" << offset << " bytes)" << endl;
+	return 0;
+}
@@ -0,0 +1,136 @@
+/*
+ * Texture converter: decodes images offline and saves
+ * their pixels as pre-decoded textures (see
+ * TextureFormat.h), next to the originals, with the
+ * same name and the .tex extension. The game loads
+ * those instead of the images, with no decoding.
+ *
+ * Usage:
+ *	texconv <image> [<image> ...] [--lz4]
+ *
+ * Pixels are stored as ARGB8888, the format most
+ * renderers use natively. With --lz4 they're LZ4
+ * compressed: smaller files, a quick decompression
+ * when loading.
+ *
+ * Build (needs SDL2 and SDL2_image):
+ *	g++ -std=c++11 -O2 -I"SDL Pong" -ISDL2/include -ISDL2/Image/include tools/texconv/texconv.cpp "SDL Pong/Lz4.cpp" -lSDL2 -lSDL2_image -o texconv
+ */
+
+#pragma region C++ Includes
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <cstring>
+#pragma endregion
+
+#pragma region SDL Includes
+#define SDL_MAIN_HANDLED	//	A plain console tool, no SDL entry point
+#include "SDL.h"
+#include "SDL_image.h"
+#pragma endregion
+
+#pragma region Engine Includes
+#include "TextureFormat.h"
+#include "Lz4.h"
+#pragma endregion
+
+using namespace std;
+
+#pragma region Constant Parameters
+#define LZ4_ARG "--lz4"
+#define TEXTURE_PIXEL_FORMAT SDL_PIXELFORMAT_ARGB8888
+#pragma endregion
+
+static bool Convert(const string & imagePath, bool compress)
+{
+	SDL_Surface * image = IMG_Load(imagePath.c_str());
+	if(!image)
+	{
+		cout << "Couldn't load " << imagePath << ": " << IMG_GetError() << endl;
+		return false;
+	}
+	SDL_Surface * converted = SDL_ConvertSurfaceFormat(image, TEXTURE_PIXEL_FORMAT, 0);
+	SDL_FreeSurface(image);
+	if(!converted)
+	{
+		cout << "Couldn't convert " << imagePath << ": " << SDL_GetError() << endl;
+		return false;
+	}
+
+	//	Rows are packed, with no padding
+	const uint32_t pitch = (uint32_t)converted->w * 4;
+	vector<uint8_t> pixels((size_t)pitch * converted->h);
+	for(int row = 0; row < converted->h; row++)
+		memcpy(&pixels[(size_t)row * pitch], (const uint8_t *)converted->pixels + (size_t)row * converted->pitch, pitch);
+
+	TextureFileHeader header;
+	memcpy(header.magic, TEXTURE_FILE_MAGIC, TEXTURE_FILE_MAGIC_SIZE);
+	header.version = TEXTURE_FILE_VERSION;
+	header.width = (uint32_t)converted->w;
+	header.height = (uint32_t)converted->h;
+	header.pixelFormat = TEXTURE_PIXEL_FORMAT;
+	header.pitch = pitch;
+	header.compression = TC_None;
+	SDL_FreeSurface(converted);
+
+	if(compress)
+	{
+		vector<uint8_t> compressed(Lz4::GetMaxCompressedSize(pixels.size()));
+		const size_t compressedSize = Lz4::Compress(pixels.data(), pixels.size(), compressed.data(), compressed.size());
+		if(compressedSize > 0)
+		{
+			compressed.resize(compressedSize);
+			pixels.swap(compressed);
+			header.compression = TC_Lz4;
+		}
+	}
+	header.dataSize = (uint32_t)pixels.size();
+
+	//	Same path, different extension
+	const size_t extension = imagePath.find_last_of('.');
+	const string texturePath = (extension == string::npos ? imagePath + "." : imagePath.substr(0, extension + 1)) + TEXTURE_FILE_EXTENSION;
+	ofstream texture(texturePath, ios::binary);
+	texture.write((const char *)&header, sizeof(header));
+	texture.write((const char *)pixels.data(), pixels.size());
+	if(!texture)
+	{
+		cout << "Couldn't write " << texturePath << endl;
+		return false;
+	}
+
+	cout << texturePath << ": " << header.width << "x" << header.height << ", " << (sizeof(header) + pixels.size()) << " bytes" << endl;
+	return true;
+}
+
+int main(int argc, char * argv[])
+{
+	vector<string> images;
+	bool compress = false;
+	for(int i = 1; i < argc; i++)
+		if(strcmp(argv[i], LZ4_ARG) == 0)
+			compress = true;
+		else
+			images.push_back(argv[i]);
+
+	if(images.empty())
+	{
+		cout << "Usage: texconv <image> [<image> ...] [" << LZ4_ARG << "]" << endl;
+		return 1;
+	}
+
+	if(IMG_Init(IMG_INIT_PNG | IMG_INIT_JPG) == 0)
+	{
+		cout << "Couldn't initialize SDL_image: " << IMG_GetError() << endl;
+		return 1;
+	}
+
+	int failures = 0;
+	for(const string & image : images)
+		if(!Convert(image, compress))
+			failures++;
+
+	IMG_Quit();
+	return failures == 0 ? 0 : 1;
+}